@@ -8,12 +8,152 @@
 
 #include "AlgoUtil.h"
 #include "Options.h"
+#include "Returns.h"
+#include "PlanarityTest.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ALGOUTIL_X86
+#include <immintrin.h>
+#endif
+
+// Counting sort of the elements by set label
+void UnionFind::groupSets(vector<int> &setOf, vector<int> &start, vector<int> &vertices) {
+    
+    for (int i = 0; i < n; i++) label[i] = -1;
+    
+    int sets = 0;
+    for (int i = 0; i < n; i++) {
+        int r = find(i);
+        if (label[r] == -1) label[r] = sets++;
+        setOf[i] = label[r];
+    }
+
+    std::fill(start.begin(), start.begin() + sets + 1, 0);
+    for (int i = 0; i < n; i++) start[setOf[i] + 1]++;
+    for (int c = 0; c < sets; c++) start[c+1] += start[c];
+    
+    // label is free again, use it as the insertion cursor
+    std::copy(start.begin(), start.begin() + sets, label.begin());
+    for (int i = 0; i < n; i++) vertices[label[setOf[i]]++] = i;
+}
+
+
+void SortedEdgeList::build(int n, const vector<double> &weights) {
+    if (n > 65536) Util::throwInvalidArgument("Error in SortedEdgeList: at most 65536 vertices, got %d.", n);
+    this->n = n;
+
+    long m = (long)n * (n - 1) / 2;
+    vector<unsigned int> keys(m);
+    vector<unsigned int> tempKeys(m);
+    vector<unsigned int> tempEdges(m);
+    edges.resize(m);
+
+    // Float bits made unsigned-comparable: flip every bit of negatives, the sign bit of the rest.
+    // Rounding to float is monotone, so the float order only merges neighbouring doubles.
+    long e = 0;
+    for (int u = 0; u < n; u++) {
+        for (int v = u + 1; v < n; v++, e++) {
+            float w = (float)weights[(long)u * n + v];
+            unsigned int bits;
+            memcpy(&bits, &w, sizeof(bits));
+            keys[e]  = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+            edges[e] = ((unsigned int)u << 16) | (unsigned int)v;
+        }
+    }
+
+    // Digits of 11, 11 and 10 bits; a pass is skipped if every key has the same digit
+    const int shifts[3] = {0, 11, 22};
+    vector<long> count(2048);
+    for (int pass = 0; pass < 3; pass++) {
+        int shift = shifts[pass];
+        std::fill(count.begin(), count.end(), 0);
+        for (long i = 0; i < m; i++) count[(keys[i] >> shift) & 2047]++;
+        if (m == 0 || count[(keys[0] >> shift) & 2047] == m) continue;
+
+        long sum = 0;
+        for (int d = 0; d < 2048; d++) {
+            long c = count[d];
+            count[d] = sum;
+            sum += c;
+        }
+        for (long i = 0; i < m; i++) {
+            long pos = count[(keys[i] >> shift) & 2047]++;
+            tempKeys [pos] = keys[i];
+            tempEdges[pos] = edges[i];
+        }
+        keys .swap(tempKeys);
+        edges.swap(tempEdges);
+    }
+
+    // Runs of equal floats in double order
+    for (long i = 0; i < m; ) {
+        long j = i + 1;
+        while (j < m && keys[j] == keys[i]) j++;
+        if (j - i > 1) {
+            std::stable_sort(edges.begin() + i, edges.begin() + j, [&](unsigned int a, unsigned int b) {
+                return weights[(long)(a >> 16) * n + (a & 0xffff)] < weights[(long)(b >> 16) * n + (b & 0xffff)];
+            });
+        }
+        i = j;
+    }
+}
+
+
+bool SortedEdgeList::subsetMST(const vector<int> &vertices, const vector<double> &weights, vector<MSTEdge> &tree, Workspace &ws) const {
+    int k = vertices.size();
+    tree.clear();
+    if (k <= 1) return true;
+
+    ws.member.assign((n + 63) / 64, 0);
+    if ((int)ws.localIndex.size() < n) ws.localIndex.resize(n);
+    for (int i = 0; i < k; i++) {
+        ws.member[vertices[i] >> 6] |= 1ULL << (vertices[i] & 63);
+        ws.localIndex[vertices[i]] = i;
+    }
+    ws.sets.initialise(k);
+
+    const unsigned long long *member = &ws.member[0];
+    long m = edges.size();
+    for (long e = 0; e < m; e++) {
+        unsigned int u = edges[e] >> 16;
+        unsigned int v = edges[e] & 0xffff;
+        if (!((member[u >> 6] >> (u & 63)) & (member[v >> 6] >> (v & 63)) & 1)) continue;
+
+        int a = ws.localIndex[u];
+        int b = ws.localIndex[v];
+        if (!ws.sets.unite(a, b)) continue;
+        
+        MSTEdge edge;
+        edge.u      = a;
+        edge.v      = b;
+        edge.weight = weights[(long)u * n + v];
+        tree.push_back(edge);
+        if ((int)tree.size() == k - 1) return true;
+    }
+    return false;
+}
+
 
 int AlgoUtil::computeSMaxTree(int k, int p) {
     if (k >= 2*p + 1) return 4*k + 2*p*p - 6*p - 4;
     else              return (p + 2)*k - (3*p + 2);    
 }
 
+int AlgoUtil::computeSMaxBound(int kMin, int kMax) {
+    int smax = 0;
+    for (int k = kMin; k <= kMax; k++) {
+        for (int p = 2; p < k; p++) {
+            int s = computeSMaxTree(k, p);
+            if (s > smax) smax = s;
+        }
+    }
+    return smax;
+}
+
 int AlgoUtil::isConnected(const vector<vector<int> >    &graph, 
                           const vector<vector<double> > &distance,
                           vector<int>                   &notConnected) { 
@@ -21,12 +161,14 @@ int AlgoUtil::isConnected(const vector<vector<int> >    &graph,
     notConnected.resize(graph.size());
     std::fill(notConnected.begin(), notConnected.end(), 1);
     
-    vector<int> visitQueue(1);
-    visitQueue[0] = 0;
+    // The head walks over the queue instead of erasing its front (which made the BFS quadratic)
+    vector<int> visitQueue;
+    visitQueue.reserve(graph.size());
+    visitQueue.push_back(0);
     notConnected[0] = 0;
 
-    while (visitQueue.size() > 0) {
-        int i = visitQueue[0];
+    for (unsigned head = 0; head < visitQueue.size(); head++) {
+        int i = visitQueue[head];
         for (int j = 0; j < (int)graph[i].size(); j++) {
             int jj = graph[i][j];
             if (distance[i][j] > TOLERANCE) {
@@ -36,7 +178,6 @@ int AlgoUtil::isConnected(const vector<vector<int> >    &graph,
                  }
             }
         }
-        visitQueue.erase(visitQueue.begin());
     }
 
     int numDisconnected = 0;
@@ -72,27 +213,26 @@ int AlgoUtil::disconnectedComponents(const vector<vector<int> >    &graph,
         
         components[currentComponent].reserve(verticesLeft);
         
-        vector<int> visitQueue(1);
+        // The component itself is the BFS queue
+        vector<int> &visitQueue = components[currentComponent];
         
-        visitQueue[0] = minIndexLeft;
-        components[currentComponent].push_back(minIndexLeft);
+        visitQueue.push_back(minIndexLeft);
         visited[minIndexLeft] = 1;
         verticesLeft--;
  
-        while (visitQueue.size() > 0) {
-            int i = visitQueue[0];
+        for (unsigned head = 0; head < visitQueue.size(); head++) {
+            int i = visitQueue[head];
             for (int j = 0; j < (int)graph[i].size(); j++) {
                 int jj = graph[i][j];
                 if (visited[jj] == 0) {
                     visitQueue.push_back(jj);
-                    components[currentComponent].push_back(jj);
                     visited[jj] = 1;
                     verticesLeft--;
                 }
             }
-            visitQueue.erase(visitQueue.begin());
         }
        
+        // Vertices before minIndexLeft are all visited, the scan resumes from there
         int found = 0;
         for (unsigned i = minIndexLeft + 1; i < graph.size(); i++) {
             if (visited[i] == 0) {
@@ -124,3 +264,554 @@ int AlgoUtil::disconnectedComponents(const vector<vector<int> >    &graph,
 }
 
 
+int AlgoUtil::connectedComponentsBitset(int                              n,
+                                        int                              words,
+                                        const vector<unsigned long long> &adjacency,
+                                        vector<int>                      &componentOf,
+                                        vector<int>                      &componentStart,
+                                        vector<int>                      &componentVertices) {
+    if (n == 0) return 0;
+    switch (words) {
+        case 1: return bitsetComponents<1>(n, &adjacency[0], &componentOf[0], &componentStart[0], &componentVertices[0]);
+        case 2: return bitsetComponents<2>(n, &adjacency[0], &componentOf[0], &componentStart[0], &componentVertices[0]);
+        case 4: return bitsetComponents<4>(n, &adjacency[0], &componentOf[0], &componentStart[0], &componentVertices[0]);
+    }
+    Util::throwInvalidArgument("Error in connectedComponentsBitset: %d words per row is not supported (valid values are 1, 2 and 4).", words);
+    return 0;
+}
+
+
+////////////////////////////////////////
+// Minimum spanning trees
+
+// One step of dense Prim after u joined the tree: best[v] = min(best[v], row[v] + penalty[v]),
+// with u recorded as the parent of every v that improves, then returns the v of smallest 
+// best. penalty is +inf for the vertices in the tree, whose best is +inf too.
+typedef int (*PrimKernel)(int n, const double* row, const double* penalty, double* best, double* parent, double u);
+
+static int primStepScalar(int n, const double* row, const double* penalty, double* best, double* parent, double u) {
+    int argMin = -1;
+    double minValue = std::numeric_limits<double>::infinity();
+    for (int v = 0; v < n; v++) {
+        double c = row[v] + penalty[v];
+        if (c < best[v]) {
+            best[v]   = c;
+            parent[v] = u;
+        }
+        if (best[v] < minValue) {
+            minValue = best[v];
+            argMin   = v;
+        }
+    }
+    return argMin;
+}
+
+#ifdef ALGOUTIL_X86
+// Parents are kept as doubles so that they can be blended with the same mask as the weights
+__attribute__((target("avx2")))
+static int primStepAVX2(int n, const double* row, const double* penalty, double* best, double* parent, double u) {
+    const double infinity = std::numeric_limits<double>::infinity();
+    __m256d vu       = _mm256_set1_pd(u);
+    __m256d minValue = _mm256_set1_pd(infinity);
+    __m256d minIndex = _mm256_set1_pd(-1);
+    __m256d index    = _mm256_setr_pd(0, 1, 2, 3);
+    __m256d four     = _mm256_set1_pd(4);
+    
+    int v = 0;
+    for (; v + 4 <= n; v += 4) {
+        __m256d c      = _mm256_add_pd(_mm256_loadu_pd(row + v), _mm256_loadu_pd(penalty + v));
+        __m256d b      = _mm256_loadu_pd(best + v);
+        __m256d better = _mm256_cmp_pd(c, b, _CMP_LT_OQ);
+        b = _mm256_blendv_pd(b, c, better);
+        _mm256_storeu_pd(best + v, b);
+        _mm256_storeu_pd(parent + v, _mm256_blendv_pd(_mm256_loadu_pd(parent + v), vu, better));
+        
+        __m256d smaller = _mm256_cmp_pd(b, minValue, _CMP_LT_OQ);
+        minValue = _mm256_blendv_pd(minValue, b, smaller);
+        minIndex = _mm256_blendv_pd(minIndex, index, smaller);
+        index    = _mm256_add_pd(index, four);
+    }
+
+    double values[4];
+    double indices[4];
+    _mm256_storeu_pd(values, minValue);
+    _mm256_storeu_pd(indices, minIndex);
+    // Each lane holds the first index of its minimum; ties between lanes go to the lowest 
+    // index, so that the vertex is the one the scalar scan returns
+    int argMin = -1;
+    double minScalar = infinity;
+    for (int l = 0; l < 4; l++) {
+        if (indices[l] < 0) continue;
+        if (values[l] < minScalar || (values[l] == minScalar && (int)indices[l] < argMin)) {
+            minScalar = values[l];
+            argMin    = (int)indices[l];
+        }
+    }
+    
+    for (; v < n; v++) {
+        double c = row[v] + penalty[v];
+        if (c < best[v]) {
+            best[v]   = c;
+            parent[v] = u;
+        }
+        if (best[v] < minScalar) {
+            minScalar = best[v];
+            argMin    = v;
+        }
+    }
+    return argMin;
+}
+#endif
+
+static PrimKernel selectPrimKernel() {
+#ifdef ALGOUTIL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return primStepAVX2;
+#endif
+    return primStepScalar;
+}
+
+static PrimKernel primStep = selectPrimKernel();
+
+
+vector<MSTEdge> AlgoUtil::minimumSpanningTree(int n, const vector<double> &weights, int threads, int boruvkaSize) {
+    if ((long)weights.size() < (long)n * n) 
+        Util::throwInvalidArgument("Error in minimumSpanningTree: %d x %d weights expected, %d found.", n, n, (int)weights.size());
+    threads = Util::getNumThreads(threads);
+
+    if (n >= boruvkaSize && threads > 1) return boruvka(n, weights, threads);
+    return primDense(n, weights);
+}
+
+
+vector<MSTEdge> AlgoUtil::primDense(int n, const vector<double> &weights) {
+    vector<MSTEdge> tree;
+    vector<double>  buffer;
+    primDense(n, &weights[0], tree, buffer);
+    return tree;
+}
+
+
+// O(n^2): one row scan per vertex added
+void AlgoUtil::primDense(int n, const double *weights, vector<MSTEdge> &tree, vector<double> &buffer) {
+    tree.clear();
+    if (n <= 1) return;
+    
+    const double infinity = std::numeric_limits<double>::infinity();
+    if ((int)buffer.size() < 3*n) buffer.resize(3*n);
+    double *best    = &buffer[0];
+    double *parent  = &buffer[n];
+    double *penalty = &buffer[2*n];
+    std::fill(best,    best + n,    infinity);
+    std::fill(parent,  parent + n,  -1.0);
+    std::fill(penalty, penalty + n, 0.0);
+    
+    int u = 0;
+    for (int added = 0; added < n-1; added++) {
+        penalty[u] = infinity;
+        best[u]    = infinity;
+        int v = primStep(n, weights + (long)u * n, penalty, best, parent, u);
+        
+        int p = (int)parent[v];
+        MSTEdge edge;
+        edge.u      = std::min(p, v);
+        edge.v      = std::max(p, v);
+        edge.weight = weights[(long)p * n + v];
+        tree.push_back(edge);
+        u = v;
+    }
+}
+
+
+// Reusable barrier for threads working in lockstep
+class StepBarrier {
+    
+    private:
+
+        std::mutex              mutex;
+        std::condition_variable released;
+        int count;
+        int waiting;
+        int generation;
+
+    public:
+
+        StepBarrier(int count) : count(count), waiting(0), generation(0) {}
+
+        void wait() {
+            std::unique_lock<std::mutex> lock(mutex);
+            int current = generation;
+            if (++waiting == count) {
+                waiting = 0;
+                generation++;
+                released.notify_all();
+            } else {
+                released.wait(lock, [&] { return generation != current; });
+            }
+        }
+};
+
+
+// Each thread owns a range of vertices and runs primStep on it, so a step needs a single barrier: 
+// every thread then reads the proposals of all threads and picks the same next vertex. Proposals 
+// alternate between two slots per thread, so one can be written while the previous is still read.
+vector<MSTEdge> AlgoUtil::primReturns(const Returns &returns, int threads) {
+    int n = returns.getNumAssets();
+    vector<MSTEdge> tree;
+    if (n <= 1) return tree;
+
+    const double infinity = std::numeric_limits<double>::infinity();
+    threads = std::max(1, std::min(Util::getNumThreads(threads), n / 64));
+    
+    vector<double> best   (n, infinity);
+    vector<double> parent (n, -1.0);
+    vector<double> penalty(n, 0.0);
+    vector<double> row    (n, 0.0);
+    
+    struct Proposal {
+        double value;
+        int    vertex;
+        int    parent;
+    };
+    vector<Proposal> proposals(2 * threads);
+    StepBarrier barrier(threads);
+    tree.reserve(n - 1);
+
+    auto worker = [&](int thread) {
+        int begin = (long)n * thread / threads;
+        int end   = (long)n * (thread + 1) / threads;
+        
+        int u = 0;
+        for (int added = 0; added < n-1; added++) {
+            if (u >= begin && u < end) {
+                penalty[u] = infinity;
+                best[u]    = infinity;
+            }
+            returns.getDistanceRow(u, begin, end, &penalty[0], &row[begin]);
+            
+            Proposal &proposal = proposals[2 * thread + (added & 1)];
+            int v = end > begin ? primStep(end - begin, &row[begin], &penalty[begin], &best[begin], &parent[begin], u) : -1;
+            proposal.value  = v >= 0 ? best[begin + v] : infinity;
+            proposal.vertex = v >= 0 ? begin + v : -1;
+            proposal.parent = v >= 0 ? (int)parent[begin + v] : -1;
+            
+            barrier.wait();
+
+            // Ties go to the lowest thread, as in a single scan
+            const Proposal *chosen = &proposals[added & 1];
+            for (int t = 1; t < threads; t++) {
+                const Proposal &other = proposals[2 * t + (added & 1)];
+                if (other.vertex >= 0 && (chosen->vertex < 0 || other.value < chosen->value)) chosen = &other;
+            }
+            
+            if (thread == 0) {
+                MSTEdge edge;
+                edge.u      = std::min(chosen->parent, chosen->vertex);
+                edge.v      = std::max(chosen->parent, chosen->vertex);
+                edge.weight = chosen->value;
+                tree.push_back(edge);
+            }
+            u = chosen->vertex;
+        }
+    };
+
+    vector<std::thread> workers;
+    for (int t = 1; t < threads; t++) workers.push_back(std::thread(worker, t));
+    worker(0);
+    for (unsigned t = 0; t < workers.size(); t++) workers[t].join();
+
+    return tree;
+}
+
+
+// Every round each vertex finds its lightest edge leaving its component (rows split among 
+// the threads), then each component takes the lightest of its vertices. Ties are broken by
+// the endpoints so that the order is total and no cycle can be formed. At most log2(n) rounds.
+vector<MSTEdge> AlgoUtil::boruvka(int n, const vector<double> &weights, int threads) {
+    vector<MSTEdge> tree;
+    if (n <= 1) return tree;
+    tree.reserve(n-1);
+    threads = std::min(Util::getNumThreads(threads), n);
+
+    UnionFind sets;
+    sets.initialise(n);
+    vector<int>    component(n);
+    vector<int>    cheapest(n);
+    vector<double> cheapestWeight(n);
+    vector<int>    componentBest(n);
+
+    // (weight, smaller endpoint, larger endpoint) of the edge from u to cheapest[u]
+    auto lighter = [&](int a, int b) {
+        if (cheapestWeight[a] != cheapestWeight[b]) return cheapestWeight[a] < cheapestWeight[b];
+        int a1 = std::min(a, cheapest[a]);
+        int b1 = std::min(b, cheapest[b]);
+        if (a1 != b1) return a1 < b1;
+        return std::max(a, cheapest[a]) < std::max(b, cheapest[b]);
+    };
+
+    auto scanRows = [&](int begin, int end) {
+        for (int u = begin; u < end; u++) {
+            const double* row = &weights[(long)u * n];
+            int cu = component[u];
+            int target = -1;
+            double w = std::numeric_limits<double>::infinity();
+            for (int v = 0; v < n; v++) {
+                if (component[v] != cu && row[v] < w) {
+                    w = row[v];
+                    target = v;
+                }
+            }
+            cheapest[u]       = target;
+            cheapestWeight[u] = w;
+        }
+    };
+
+    while ((int)tree.size() < n-1) {
+        for (int v = 0; v < n; v++) component[v] = sets.find(v);
+
+        vector<std::thread> workers;
+        for (int t = 1; t < threads; t++) workers.push_back(std::thread(scanRows, (long)n * t / threads, (long)n * (t+1) / threads));
+        scanRows(0, n / threads);
+        for (unsigned t = 0; t < workers.size(); t++) workers[t].join();
+
+        std::fill(componentBest.begin(), componentBest.end(), -1);
+        for (int u = 0; u < n; u++) {
+            if (cheapest[u] < 0) continue;
+            int c = component[u];
+            if (componentBest[c] == -1 || lighter(u, componentBest[c])) componentBest[c] = u;
+        }
+        
+        int added = 0;
+        for (int c = 0; c < n; c++) {
+            int u = componentBest[c];
+            if (u == -1) continue;
+            int v = cheapest[u];
+            if (!sets.unite(u, v)) continue;
+            MSTEdge edge;
+            edge.u      = std::min(u, v);
+            edge.v      = std::max(u, v);
+            edge.weight = cheapestWeight[u];
+            tree.push_back(edge);
+            added++;
+        }
+        // Only possible with NaN weights
+        if (added == 0) Util::throwInvalidArgument("Error in boruvka: the graph could not be connected.");
+    }
+    return tree;
+}
+
+
+double AlgoUtil::treeWeight(const vector<MSTEdge> &tree) {
+    double total = 0;
+    for (unsigned e = 0; e < tree.size(); e++) total += tree[e].weight;
+    return total;
+}
+
+
+// Joining two components cannot create a subdivision of K5 or K3,3 (both are 2-connected), and 
+// neither can a graph of at most 8 edges contain one, so only the remaining candidates are tested.
+// Threads test consecutive candidates against the same graph. A candidate rejected there stays 
+// rejected, as graphs only grow, so the batch is resolved by accepting its first planar candidate 
+// and dropping the ones before it; the ones after it are tested again on the larger graph.
+vector<MSTEdge> AlgoUtil::pmfg(int n, const vector<double> &weights, const SortedEdgeList *edges, int threads) {
+    vector<MSTEdge> graph;
+    if (n < 2) return graph;
+    
+    SortedEdgeList ownEdges;
+    if (edges == NULL) {
+        ownEdges.build(n, weights);
+        edges = &ownEdges;
+    }
+    threads = Util::getNumThreads(threads);
+    
+    long target = n >= 3 ? 3L * (n - 2) : 1;
+    long numEdges = edges->getNumEdges();
+    UnionFind components;
+    components.initialise(n);
+    vector<int> graphU;
+    vector<int> graphV;
+    graphU.reserve(target);
+    graphV.reserve(target);
+    
+    auto accept = [&](int u, int v) {
+        components.unite(u, v);
+        graphU.push_back(u);
+        graphV.push_back(v);
+        MSTEdge edge;
+        edge.u      = u;
+        edge.v      = v;
+        edge.weight = weights[(long)u * n + v];
+        graph.push_back(edge);
+    };
+
+    vector<PlanarityTest> tests(threads);
+    vector<long> candidate(threads);
+    vector<char> planar(threads);
+    long next = 0;
+    bool finished = false;
+    StepBarrier barrier(threads);
+
+    auto worker = [&](int thread) {
+        while (true) {
+            if (thread == 0) {
+                int batch = 0;
+                while (next < numEdges && (long)graph.size() < target && batch < threads) {
+                    int u = edges->getU(next);
+                    int v = edges->getV(next);
+                    bool free = graph.size() < 8 || components.find(u) != components.find(v);
+                    if (free && batch > 0) break;
+                    if (free) accept(u, v);
+                    else      candidate[batch++] = next;
+                    next++;
+                }
+                for (int t = batch; t < threads; t++) candidate[t] = -1;
+                finished = batch == 0;
+            }
+            barrier.wait();
+            if (finished) return;
+
+            long c = candidate[thread];
+            if (c >= 0) planar[thread] = tests[thread].isPlanar(n, graphU.size(), &graphU[0], &graphV[0], edges->getU(c), edges->getV(c));
+            barrier.wait();
+
+            if (thread == 0) {
+                for (int t = 0; t < threads && candidate[t] >= 0; t++) {
+                    if (!planar[t]) continue;
+                    accept(edges->getU(candidate[t]), edges->getV(candidate[t]));
+                    next = candidate[t] + 1;
+                    break;
+                }
+            }
+        }
+    };
+
+    vector<std::thread> workers;
+    for (int t = 1; t < threads; t++) workers.push_back(std::thread(worker, t));
+    worker(0);
+    for (unsigned t = 0; t < workers.size(); t++) workers[t].join();
+    
+    return graph;
+}
+
+
+vector<MSTEdge> AlgoUtil::tmfg(int n, const vector<double> &weights) {
+    vector<MSTEdge> graph;
+    auto addEdge = [&](int u, int v) {
+        MSTEdge edge;
+        edge.u      = std::min(u, v);
+        edge.v      = std::max(u, v);
+        edge.weight = weights[(long)u * n + v];
+        graph.push_back(edge);
+    };
+
+    // Small graphs are planar as they are
+    if (n <= 4) {
+        for (int u = 0; u < n; u++) for (int v = u + 1; v < n; v++) addEdge(u, v);
+        return graph;
+    }
+
+    // The tetrahedron is made of the 4 vertices closest to all the others
+    vector<std::pair<int, double>> total(n);
+    for (int u = 0; u < n; u++) {
+        double sum = 0;
+        for (int v = 0; v < n; v++) sum += weights[(long)u * n + v];
+        total[u] = std::make_pair(u, -sum);
+    }
+    std::stable_sort(total.begin(), total.end(), Util::sortPairDesc<int, double>());
+    
+    vector<char> inGraph(n, 0);
+    int tetrahedron[4];
+    for (int k = 0; k < 4; k++) {
+        tetrahedron[k] = total[k].first;
+        inGraph[tetrahedron[k]] = 1;
+    }
+    for (int a = 0; a < 4; a++) for (int b = a + 1; b < 4; b++) addEdge(tetrahedron[a], tetrahedron[b]);
+
+    // Every face keeps its closest outside vertex, which is only searched again when taken
+    struct Face {
+        int    a, b, c;
+        int    best;
+        double cost;
+    };
+    vector<Face> faces;
+    auto evaluate = [&](Face &face) {
+        const double *rowA = &weights[(long)face.a * n];
+        const double *rowB = &weights[(long)face.b * n];
+        const double *rowC = &weights[(long)face.c * n];
+        face.best = -1;
+        face.cost = std::numeric_limits<double>::infinity();
+        for (int v = 0; v < n; v++) {
+            if (inGraph[v]) continue;
+            double cost = rowA[v] + rowB[v] + rowC[v];
+            if (cost < face.cost) {
+                face.cost = cost;
+                face.best = v;
+            }
+        }
+    };
+    auto addFace = [&](int a, int b, int c) {
+        Face face;
+        face.a = a;
+        face.b = b;
+        face.c = c;
+        evaluate(face);
+        faces.push_back(face);
+    };
+    for (int k = 0; k < 4; k++) addFace(tetrahedron[k], tetrahedron[(k+1) % 4], tetrahedron[(k+2) % 4]);
+
+    for (int inserted = 4; inserted < n; inserted++) {
+        int f = 0;
+        for (unsigned g = 1; g < faces.size(); g++) if (faces[g].cost < faces[f].cost) f = g;
+        
+        Face face = faces[f];
+        int v = face.best;
+        inGraph[v] = 1;
+        addEdge(face.a, v);
+        addEdge(face.b, v);
+        addEdge(face.c, v);
+        
+        for (unsigned g = 0; g < faces.size(); g++) if (faces[g].best == v && (int)g != f) evaluate(faces[g]);
+        faces[f].c = v;
+        evaluate(faces[f]);
+        addFace(face.a, face.c, v);
+        addFace(face.b, face.c, v);
+    }
+    return graph;
+}
+
+
+// Assortativity is the correlation over both orientations of every edge, so both ends 
+// have the same mean and variance: r = (<d_u d_v> - mean^2) / (<d^2> - mean^2).
+// It is NaN when every end has the same degree, as cor() in R.
+TreeIndices AlgoUtil::treeIndices(int n, const vector<MSTEdge> &tree, vector<int> &degree) {
+    degree.assign(n, 0);
+    for (unsigned e = 0; e < tree.size(); e++) {
+        degree[tree[e].u]++;
+        degree[tree[e].v]++;
+    }
+
+    TreeIndices indices;
+    indices.randic       = 0;
+    indices.squaredDiff  = 0;
+    indices.absoluteDiff = 0;
+    
+    double sum        = 0;
+    double sumSquares = 0;
+    for (unsigned e = 0; e < tree.size(); e++) {
+        double du = degree[tree[e].u];
+        double dv = degree[tree[e].v];
+        indices.randic       += du * dv;
+        indices.squaredDiff  += (du - dv) * (du - dv);
+        indices.absoluteDiff += fabs(du - dv);
+        sum        += du + dv;
+        sumSquares += du * du + dv * dv;
+    }
+    
+    double ends     = 2.0 * tree.size();
+    double mean     = sum / ends;
+    double variance = sumSquares / ends - mean * mean;
+    double product  = 2 * indices.randic / ends;
+    indices.assortativity = variance > 1e-12 ? (product - mean * mean) / variance : std::numeric_limits<double>::quiet_NaN();
+    
+    return indices;
+}
@@ -11,6 +11,131 @@
 
 #include "Util.h"
 
+class Returns;
+
+////////////////////////////////////////
+
+/**
+ * Disjoint sets over 0..n-1 with path halving and union by size. initialise 
+ * only touches the first n entries, so a structure sized once can be reused 
+ * for smaller graphs.
+ */
+class UnionFind {
+
+    private:
+
+        vector<int> parent;
+        vector<int> setSize;
+        vector<int> label;
+        int n;
+        int numSets;
+
+    public:
+
+        UnionFind() : n(0), numSets(0) {}
+
+        void initialise(int n) {
+            if ((int)parent.size() < n) {
+                parent.resize(n);
+                setSize.resize(n);
+                label.resize(n);
+            }
+            this->n = n;
+            numSets = n;
+            for (int i = 0; i < n; i++) {
+                parent[i]  = i;
+                setSize[i] = 1;
+            }
+        }
+
+        int find(int i) {
+            while (parent[i] != i) {
+                parent[i] = parent[parent[i]];
+                i = parent[i];
+            }
+            return i;
+        }
+
+        // Returns true if i and j were in different sets
+        bool unite(int i, int j) {
+            i = find(i);
+            j = find(j);
+            if (i == j) return false;
+            if (setSize[i] < setSize[j]) std::swap(i, j);
+            parent[j] = i;
+            setSize[i] += setSize[j];
+            numSets--;
+            return true;
+        }
+
+        int getNumSets() const { return numSets; }
+        int getSetSize(int i)  { return setSize[find(i)]; }
+
+        // Groups the elements by set: on return the elements of set c are 
+        // vertices[start[c]..start[c+1]) and setOf[i] is the set of i, sets numbered by 
+        // first element. Buffers must hold at least n (n+1 for start) elements.
+        void groupSets(vector<int> &setOf, vector<int> &start, vector<int> &vertices);
+};
+
+////////////////////////////////////////
+
+// Edge of a spanning tree, u < v
+struct MSTEdge {
+    int    u;
+    int    v;
+    double weight;
+};
+
+// Degree based indices of a tree
+struct TreeIndices {
+    double assortativity;  // Pearson correlation of the degrees at the two ends of each edge
+    double randic;         // sum over edges of d_u d_v
+    double squaredDiff;    // sum over edges of (d_u - d_v)^2
+    double absoluteDiff;   // sum over edges of |d_u - d_v|
+};
+
+////////////////////////////////////////
+
+/**
+ * Edges of the complete graph on n vertices sorted once by weight, so that the
+ * Kruskal order of any subset of the vertices is this order filtered to the edges
+ * inside the subset. Edges are packed in 32 bits (u << 16 | v, u < v), so n is
+ * at most 65536; weights are not kept and are read from the matrix when needed.
+ */
+class SortedEdgeList {
+
+    private:
+
+        int n;
+        vector<unsigned int> edges;
+
+    public:
+
+        // Buffers of subsetMST, one per thread
+        struct Workspace {
+            vector<unsigned long long> member;
+            vector<int>                localIndex;
+            UnionFind                  sets;
+        };
+
+        SortedEdgeList() : n(0) {}
+
+        // weights is the n x n row-major symmetric matrix. Least significant digit radix 
+        // sort on the bits of the weights as floats, then runs of equal floats are put 
+        // in double order, so the order is exact. Ties keep the (u, v) order.
+        void build(int n, const vector<double> &weights);
+
+        int  getNumVertices() const { return n; }
+        long getNumEdges()    const { return edges.size(); }
+        int  getU(long e)     const { return edges[e] >> 16; }
+        int  getV(long e)     const { return edges[e] & 0xffff; }
+
+        // Kruskal on the subset vertices (sorted, distinct), stopping after |vertices| - 1 
+        // edges. Tree edges are numbered by position in vertices, as primDense on the 
+        // sub-matrix would. Returns false if the scan ran out of edges.
+        bool subsetMST(const vector<int> &vertices, const vector<double> &weights, vector<MSTEdge> &tree, Workspace &ws) const;
+};
+
 ////////////////////////////////////////
 
 class AlgoUtil {
@@ -21,6 +146,8 @@ class AlgoUtil {
     public:
 
         static int computeSMaxTree(int k, int p);
+        // Largest computeSMaxTree over tree sizes kMin..kMax and every valid maximum degree
+        static int computeSMaxBound(int kMin, int kMax);
 
 
         static int isConnected(const vector<vector<int> >    &graph, 
@@ -33,7 +160,113 @@ class AlgoUtil {
                                           const vector<vector<double> > &distance,
                                           vector<vector<int>>           &components);
 
+        // Components of an undirected graph on a bitset adjacency: row i is the words 
+        // adjacency[i*words..(i+1)*words), bit j set if i and j are adjacent. The BFS 
+        // expands a whole frontier at a time with word-wide OR / AND-NOT. words must be
+        // 1, 2 or 4 (n up to 64, 128 or 256), use bitsetWords to pick it.
+        // On return the vertices of component c are componentVertices[componentStart[c]..componentStart[c+1])
+        // and componentOf[i] is the component of i. Buffers must hold at least n (n+1 for componentStart) 
+        // elements and are not resized. Returns the number of components.
+        static int connectedComponentsBitset(int                              n,
+                                             int                              words,
+                                             const vector<unsigned long long> &adjacency,
+                                             vector<int>                      &componentOf,
+                                             vector<int>                      &componentStart,
+                                             vector<int>                      &componentVertices);
+
+        // Minimum spanning tree of the complete graph whose weights are the n x n row-major 
+        // symmetric matrix weights. Dense Prim up to boruvkaSize vertices, Boruvka on 
+        // threads (0 for every core) above it. Returns the n-1 edges in the order they were added.
+        static vector<MSTEdge> minimumSpanningTree(int n, const vector<double> &weights, int threads = 1, int boruvkaSize = 4096);
+        static vector<MSTEdge> primDense(int n, const vector<double> &weights);
+        // Same, reusing tree and buffer (3n doubles) between calls
+        static void primDense(int n, const double *weights, vector<MSTEdge> &tree, vector<double> &buffer);
+        static vector<MSTEdge> boruvka(int n, const vector<double> &weights, int threads);
+        // Prim on the Mantegna distances of the returns, computing one row of distances per
+        // step instead of storing the matrix. Vertices are split among the threads (0 for 
+        // every core), which compute their part of the row and propose their closest vertex.
+        static vector<MSTEdge> primReturns(const Returns &returns, int threads = 1);
+        static double treeWeight(const vector<MSTEdge> &tree);
+
+        // Planar maximally filtered graph: edges by increasing weight, kept if the graph stays 
+        // planar, until it has 3(n-2). Reuses edges if given, otherwise sorts its own. Candidates
+        // are tested on threads (0 for every core); the result does not depend on their number.
+        static vector<MSTEdge> pmfg(int n, const vector<double> &weights, const SortedEdgeList *edges = NULL, int threads = 1);
+        // Triangulated maximally filtered graph (Massara et al.), a greedy O(n^2) approximation of 
+        // the PMFG: starting from a tetrahedron, the vertex closest to a triangular face is inserted in it
+        static vector<MSTEdge> tmfg(int n, const vector<double> &weights);
+        
+        // Degree based indices of a tree on n vertices, as in the R package (graph.r).
+        // degree is a buffer resized to n
+        static TreeIndices treeIndices(int n, const vector<MSTEdge> &tree, vector<int> &degree);
+
+        // Smallest specialisation of the bitset kernels that holds n vertices, 0 if there is none
+        static int bitsetWords(int n) { return n <= 64 ? 1 : n <= 128 ? 2 : n <= 256 ? 4 : 0; }
+
+        template <int W>
+        static int bitsetComponents(int n, const unsigned long long *adjacency, int *componentOf, int *componentStart, 
+                                    int *componentVertices);
 
 };    
 
+
+// Word count is a template parameter so that every loop over the words of a row 
+// is unrolled.
+template <int W>
+int AlgoUtil::bitsetComponents(int n, const unsigned long long *adjacency, int *componentOf, int *componentStart, 
+                               int *componentVertices) {
+
+    unsigned long long unvisited[W];
+    unsigned long long frontier[W];
+    unsigned long long next[W];
+    for (int w = 0; w < W; w++) {
+        int bits = std::min(64, std::max(0, n - 64*w));
+        unvisited[w] = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+    }
+
+    int numComponents = 0;
+    int numVisited    = 0;
+    componentStart[0] = 0;
+    
+    for (int first = 0; first < W; ) {
+        if (unvisited[first] == 0) {
+            first++;
+            continue;
+        }
+        
+        int root = 64*first + __builtin_ctzll(unvisited[first]);
+        for (int w = 0; w < W; w++) frontier[w] = 0;
+        frontier[root >> 6] = 1ULL << (root & 63);
+        unvisited[root >> 6] &= ~frontier[root >> 6];
+        
+        // Frontier expansion: next = (OR of the rows in the frontier) AND NOT visited
+        bool growing = true;
+        while (growing) {
+            for (int w = 0; w < W; w++) next[w] = 0;
+            for (int fw = 0; fw < W; fw++) {
+                unsigned long long bits = frontier[fw];
+                while (bits) {
+                    int u = 64*fw + __builtin_ctzll(bits);
+                    bits &= bits - 1;
+                    componentOf[u] = numComponents;
+                    componentVertices[numVisited++] = u;
+                    const unsigned long long *row = adjacency + (long)u * W;
+                    for (int w = 0; w < W; w++) next[w] |= row[w];
+                }
+            }
+            growing = false;
+            for (int w = 0; w < W; w++) {
+                next[w]      &= unvisited[w];
+                unvisited[w] &= ~next[w];
+                frontier[w]   = next[w];
+                if (next[w]) growing = true;
+            }
+        }
+        
+        numComponents++;
+        componentStart[numComponents] = numVisited;
+    }
+    return numComponents;
+}
+
 #endif 
@@ -11,11 +11,17 @@
 #include "ModelAssortMST.h"
 #include "Options.h"
 #include "AlgoUtil.h"
+#include "TreeAnalytics.h"
 
 
 
 AssortMST::AssortMST() {
     totalTime = 0;
+
+    combinationsSolved  = 0;
+    combinationsSkipped = 0;
+
+    totalNodes = 0;
 }
 
 AssortMST::~AssortMST() {
@@ -28,21 +34,13 @@ void AssortMST::execute() {
     data.readData();
     data.print();
    
-    // Aqui seria executado o for pra resolver o numero
-    // quadratico de problemas
-
-    ModelAssortMST model;
-
-    int K = Options::getInstance()->getIntOption("min_tree_size");
-
-    for (int k = K; k < data.getNumAssets();k++) {
-        for (int p = 2; p < k; p++) {
-            int smax = AlgoUtil::computeSMaxTree(k, p);
-            if (smax > 1000) printf("k = %2d, p = %2d, smax = %2d\n", k, p, smax);
-        }
-    }
-    
-    model.execute(data);
+    int benchmarkCalls = Options::getInstance()->getIntOption("benchmark_separation");
+    if (benchmarkCalls > 0) {
+        ModelAssortMST model;
+        model.benchmarkSeparation(data, benchmarkCalls);
+    } 
+    else if (Options::getInstance()->getBoolOption("bound_oracle")) executeBoundOracle(data);
+    else                                                            executeSingleModel(data);
     //model.printSolution();
  
     totalTime = Util::getTime() - startTime;
@@ -60,6 +58,10 @@ void AssortMST::execute() {
             printf("   Adding cuts             %7.3fs (%d cuts added)\n", model.getCallbackCutsTime(), model.getCutsAdded());
             printf("   Data processing         %7.3fs\n", model.getCallbackDataTime());
             printf("   BFS                     %7.3fs\n", model.getBfsTime());
+            if (model.getMaxFlowCalls() > 0) printf("   Max-flow                %7.3fs (%d calls, %d flows)\n", model.getMaxFlowTime(), model.getMaxFlowCalls(), model.getMaxFlowsSolved());
+            if (model.getSeparationsSkipped() > 0) printf("   Separations skipped     %8d\n", model.getSeparationsSkipped());
+            if (model.getCutsDuplicated() > 0)     printf("   Duplicate cuts dropped  %8d\n", model.getCutsDuplicated());
+            if (model.getCacheHits() > 0)          printf("   Separation cache hits   %8d\n", model.getCacheHits());
         }
         printf("Solver time:               %7.3fs\n",   model.getSolvingTime());
         printf("   First node solved in    %7.3fs\n",   model.getFirstNodeTime());
@@ -70,3 +72,140 @@ void AssortMST::execute() {
     */
     
 }
+
+
+void AssortMST::executeSingleModel(const Data& data) {
+
+    ModelAssortMST model;
+
+    // No tree with at least K vertices has a larger objective than the analytic bound
+    int K = Options::getInstance()->getIntOption("min_tree_size");
+    model.setOracleBound(AlgoUtil::computeSMaxBound(K, data.getNumAssets()));
+    
+    model.execute(data);
+    combinationsSolved++;
+    totalNodes += model.getTotalNodes();
+
+    if (Options::getInstance()->getIntOption("debug")) {
+        printf("\n");
+        printf("Symmetry breaking:        %8d (%d classes)\n", Options::getInstance()->getIntOption("symmetry"), model.getSymmetryClasses());
+        printf("Number of nodes solved:   %8d\n", totalNodes);
+        printf("Callback API:             %8s\n", Options::getInstance()->getStringOption("callback_api").c_str());
+        printf("Cut evaluation kernel:    %8s\n", CutArena::getKernelName());
+        printf("LP size:                  %8d rows, %d cols\n", model.getLPRows(), model.getLPCols());
+        printf("Presolved LP size:        %8d rows, %d cols\n", model.getPresolvedLPRows(), model.getPresolvedLPCols());
+        printf("Bound at first node:      %8.2f\n", model.getFirstNodeBound());
+        printf("First node solved in       %7.3fs\n", model.getFirstNodeTime());
+        // Summed over all solver threads
+        if (model.getCallbackCalls() > 0) {
+            printf("Callback time              %7.3fs (%d calls)\n", model.getCallbackTime(), model.getCallbackCalls());
+            printf("   Adding cuts             %7.3fs (%d cuts added)\n", model.getCallbackCutsTime(), model.getCutsAdded());
+            printf("   BFS                     %7.3fs\n", model.getBfsTime());
+            if (model.getMaxFlowCalls() > 0) printf("   Max-flow                %7.3fs (%d calls, %d flows)\n", model.getMaxFlowTime(), model.getMaxFlowCalls(), model.getMaxFlowsSolved());
+            if (model.getSeparationsSkipped() > 0) printf("   Separations skipped     %8d\n", model.getSeparationsSkipped());
+            if (model.getCutsDuplicated() > 0)     printf("   Duplicate cuts dropped  %8d\n", model.getCutsDuplicated());
+            if (model.getCacheHits() > 0)          printf("   Separation cache hits   %8d\n", model.getCacheHits());
+        }
+        if (model.getSolution().doesSolutionExist()) TreeAnalytics::print(TreeAnalytics::analyse(model.getSolution().getTreeEdges(data), true));
+    }
+}
+
+
+// Solves one model per (k, p) pair, where k is the exact tree size and p the maximum degree.
+// Pairs are visited in decreasing order of their analytic bound, so that once the best 
+// solution found so far attains the bound of a pair, that pair and all the remaining ones 
+// can be skipped.
+void AssortMST::executeBoundOracle(const Data& data) {
+    
+    int K = Options::getInstance()->getIntOption("min_tree_size");
+    int N = data.getNumAssets();
+    int debug = Options::getInstance()->getIntOption("debug");
+
+    // Degrees above the limit of the model give the same model as the limit itself, so p
+    // stops there and each pair is solved once with its tightest bound
+    int maxP = ModelAssortMST::getDegreeLimit(N);
+    vector<std::pair<std::pair<int, int>, int>> combinations;
+    for (int k = K; k <= N; k++) 
+        for (int p = 2; p < k && p <= maxP; p++) 
+            combinations.push_back(std::make_pair(std::make_pair(k, p), AlgoUtil::computeSMaxTree(k, p)));
+    
+    std::stable_sort(combinations.begin(), combinations.end(), Util::sortPairDesc<std::pair<int, int>, int>());
+
+    double best  = -std::numeric_limits<double>::max();
+    int    bestK = -1;
+    int    bestP = -1;
+    vector<MSTEdge> bestTree;
+
+    bool overlap = Options::getInstance()->getBoolOption("overlap_solves");
+
+    ModelAssortMST* model = NULL;
+    for (unsigned c = 0; c < combinations.size(); c++) {
+        int k    = combinations[c].first.first;
+        int p    = combinations[c].first.second;
+        int smax = combinations[c].second;
+
+        if (smax <= best + TOLERANCE) {
+            combinationsSkipped += combinations.size() - c;
+            break;
+        }
+
+        if (debug) printf("\nk = %2d, p = %2d, smax = %2d, best = %.2f\n", k, p, smax, bestK == -1 ? 0 : best);
+        
+        if (model == NULL) model = createCombinationModel(data, k, p, smax);
+        if (bestK != -1) model->setObjectiveCutoff(best);
+        SolveHandle handle = model->solveAsync();
+
+        // The next pair is built while this one is solving. It is only wasted if this solve
+        // attains its bound, and then every remaining pair is skipped anyway.
+        ModelAssortMST* next = NULL;
+        if (overlap && c + 1 < combinations.size() && combinations[c+1].second > best + TOLERANCE) 
+            next = createCombinationModel(data, combinations[c+1].first.first, combinations[c+1].first.second, combinations[c+1].second);
+
+        while (!handle.wait(1.0)) {
+            if (debug > 1) printf("   [k = %d, p = %d] nodes = %ld, incumbent = %.2f, bound = %.2f\n", k, p, 
+                                  handle.getNodeCount(), handle.hasIncumbent() ? handle.getIncumbent() : 0, handle.getBestBound());
+            
+            // Nothing better than the best pair so far can come out of this solve
+            if (bestK != -1 && handle.getBestBound() <= best + TOLERANCE) handle.cancel();
+        }
+
+        model->finishExecution(handle);
+        combinationsSolved++;
+        totalNodes += model->getTotalNodes();
+
+        Solution solution = model->getSolution();
+        if (solution.doesSolutionExist() && solution.getValue() > best) {
+            best     = solution.getValue();
+            bestK    = k;
+            bestP    = p;
+            bestTree = solution.getTreeEdges(data);
+        }
+
+        delete model;
+        model = next;
+    }
+    delete model;
+
+    if (debug) {
+        printf("\n");
+        printf("Pairs (k, p) solved:      %8d\n", combinationsSolved);
+        printf("Pairs (k, p) skipped:     %8d\n", combinationsSkipped);
+        printf("Symmetry breaking:        %8d\n", Options::getInstance()->getIntOption("symmetry"));
+        printf("Number of nodes solved:   %8d\n", totalNodes);
+        if (bestK != -1) {
+            printf("Best solution:            %8.2f (k = %d, p = %d)\n", best, bestK, bestP);
+            TreeAnalytics::print(TreeAnalytics::analyse(bestTree, true));
+        }
+        else printf("No solution found\n");
+    }
+}
+
+
+ModelAssortMST* AssortMST::createCombinationModel(const Data& data, int k, int p, int smax) {
+    ModelAssortMST* model = new ModelAssortMST();
+    model->setTreeSize(k);
+    model->setMaxDegree(p);
+    model->setOracleBound(smax);
+    model->prepare(data);
+    return model;
+}
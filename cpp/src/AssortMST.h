@@ -9,12 +9,26 @@
 #ifndef MSTASSORT_H
 #define MSTASSORT_H
 
+class Data;
+class ModelAssortMST;
+
 class AssortMST {
 
     private:
 
         double totalTime;
 
+        // Bound oracle statistics
+        int combinationsSolved;
+        int combinationsSkipped;
+        
+        // Branch-and-bound nodes over all solves (to measure the effect of symmetry breaking)
+        int totalNodes;
+
+        void executeSingleModel(const Data& data);
+        void executeBoundOracle(const Data& data);
+        ModelAssortMST* createCombinationModel(const Data& data, int k, int p, int smax);
+
     public:
    
         AssortMST();
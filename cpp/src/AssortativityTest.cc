@@ -0,0 +1,76 @@
+/**
+ * AssortativityTest.cc
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "AssortativityTest.h"
+#include "CounterRNG.h"
+
+AssortativityTest::AssortativityTest() {
+    numTests          = 1;
+    verticesInTree    = 0;
+    minVerticesInTree = 5;
+    seed              = 2016;
+    threads           = 1;
+    runTime           = 0;
+}
+
+AssortativityTest::~AssortativityTest() {
+}
+
+void AssortativityTest::setParameters(int numTests, int verticesInTree, int minVerticesInTree, unsigned long long seed, int threads) {
+    if (numTests <= 0) Util::throwInvalidArgument("Error in AssortativityTest: number of tests must be positive.");
+    this->numTests          = numTests;
+    this->verticesInTree    = verticesInTree;
+    this->minVerticesInTree = verticesInTree > 0 ? 0 : minVerticesInTree;
+    this->seed              = seed;
+    this->threads           = Util::getNumThreads(threads);
+}
+
+void AssortativityTest::run(int n, const vector<double> &distance) {
+    if (verticesInTree > n)    Util::throwInvalidArgument("Error in AssortativityTest: %d vertices in tree, but only %d assets.", verticesInTree, n);
+    if (minVerticesInTree > n) Util::throwInvalidArgument("Error in AssortativityTest: at least %d vertices in tree, but only %d assets.", minVerticesInTree, n);
+    
+    double startTime = Util::getWallTime();
+
+    numVertices  .assign(numTests, 0);
+    assortativity.assign(numTests, 0);
+    randic       .assign(numTests, 0);
+    squaredDiff  .assign(numTests, 0);
+    absoluteDiff .assign(numTests, 0);
+
+    edgeList.build(n, distance);
+
+    vector<Workspace> workspaces(threads);
+    Util::parallelFor(numTests, threads, [&](int thread, int iteration) {
+        runIteration(n, distance, iteration, workspaces[thread]);
+    });
+
+    runTime = Util::getWallTime() - startTime;
+}
+
+void AssortativityTest::runIteration(int n, const vector<double> &distance, int iteration, Workspace &ws) {
+    CounterRNG rng(seed, iteration);
+
+    int k = verticesInTree;
+    if (k == 0) k = std::max(1, minVerticesInTree) + rng.uniformInt(n - std::max(1, minVerticesInTree) + 1);
+
+    // Partial Fisher-Yates, then sorted as in the R code
+    ws.permutation.resize(n);
+    for (int i = 0; i < n; i++) ws.permutation[i] = i;
+    for (int i = 0; i < k; i++) std::swap(ws.permutation[i], ws.permutation[i + rng.uniformInt(n - i)]);
+    ws.vertices.assign(ws.permutation.begin(), ws.permutation.begin() + k);
+    std::sort(ws.vertices.begin(), ws.vertices.end());
+
+    edgeList.subsetMST(ws.vertices, distance, ws.tree, ws.kruskal);
+    TreeIndices indices = AlgoUtil::treeIndices(k, ws.tree, ws.degree);
+    
+    numVertices  [iteration] = k;
+    assortativity[iteration] = indices.assortativity;
+    randic       [iteration] = indices.randic;
+    squaredDiff  [iteration] = indices.squaredDiff;
+    absoluteDiff [iteration] = indices.absoluteDiff;
+}
@@ -0,0 +1,73 @@
+/**
+ * AssortativityTest.h
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef ASSORTATIVITYTEST_H
+#define ASSORTATIVITYTEST_H
+
+#include "Util.h"
+#include "AlgoUtil.h"
+
+/**
+ * Monte Carlo test of testAssortativity.r: every iteration samples a subset 
+ * of the assets, computes the minimum spanning tree of their distances and 
+ * the degree indices of the tree. The edges are sorted once, and the tree of 
+ * each subset is found by Kruskal on that order. Iterations run in parallel; iteration j 
+ * draws from its own counter-based stream, so results do not depend on the
+ * number of threads. Every thread reuses its own buffers.
+ */
+class AssortativityTest {
+
+    private:
+
+        struct Workspace {
+            vector<int>     permutation;
+            vector<int>     vertices;
+            vector<MSTEdge> tree;
+            vector<int>     degree;
+            SortedEdgeList::Workspace kruskal;
+        };
+
+        SortedEdgeList edgeList;
+
+        int numTests;
+        int verticesInTree;
+        int minVerticesInTree;
+        unsigned long long seed;
+        int threads;
+
+        // Results, one entry per iteration
+        vector<int>    numVertices;
+        vector<double> assortativity;
+        vector<double> randic;
+        vector<double> squaredDiff;
+        vector<double> absoluteDiff;
+
+        double runTime;
+
+        void runIteration(int n, const vector<double> &distance, int iteration, Workspace &ws);
+
+    public:
+
+        AssortativityTest();
+        ~AssortativityTest();
+
+        // verticesInTree = 0 draws the tree size uniformly from [minVerticesInTree, n]
+        void setParameters(int numTests, int verticesInTree, int minVerticesInTree, unsigned long long seed, int threads);
+
+        // distance is the full n x n row-major matrix
+        void run(int n, const vector<double> &distance);
+
+        const vector<int>    &getNumVertices()   const { return numVertices;   }
+        const vector<double> &getAssortativity() const { return assortativity; }
+        const vector<double> &getRandic()        const { return randic;        }
+        const vector<double> &getSquaredDiff()   const { return squaredDiff;   }
+        const vector<double> &getAbsoluteDiff()  const { return absoluteDiff;  }
+        double getRunTime() const { return runTime; }
+};
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * Bootstrap.cc
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "Bootstrap.h"
+#include "Returns.h"
+#include "CounterRNG.h"
+#include <cmath>
+
+Bootstrap::Bootstrap() {
+    numReplicates = 100;
+    blockLength   = 20;
+    seed          = 2016;
+    threads       = 1;
+    numAssets     = 0;
+    runTime       = 0;
+}
+
+Bootstrap::~Bootstrap() {
+}
+
+void Bootstrap::setParameters(int numReplicates, int blockLength, unsigned long long seed, int threads) {
+    if (numReplicates <= 0) Util::throwInvalidArgument("Error in Bootstrap: number of replicates must be positive.");
+    if (blockLength   <= 0) Util::throwInvalidArgument("Error in Bootstrap: block length must be positive.");
+    this->numReplicates = numReplicates;
+    this->blockLength   = blockLength;
+    this->seed          = seed;
+    this->threads       = Util::getNumThreads(threads);
+}
+
+void Bootstrap::run(const Returns &returns) {
+    double startTime = Util::getWallTime();
+    numAssets = returns.getNumAssets();
+    int N = numAssets;
+    int T = returns.getNumPeriods();
+    long numPairs = (long)N * (N - 1) / 2;
+
+    vector<Workspace> workspaces(threads);
+    for (int t = 0; t < threads; t++) workspaces[t].edgeCount.assign(numPairs, 0);
+
+    // The original sample is the resample that takes every period once
+    Workspace &first = workspaces[0];
+    first.weights.assign(T, 1.0);
+    computeTree(returns, first);
+    tree        = first.tree;
+    treeIndices = AlgoUtil::treeIndices(N, tree, first.degree);
+
+    assortativity.assign(numReplicates, 0);
+    randic       .assign(numReplicates, 0);
+    Util::parallelFor(numReplicates, threads, [&](int thread, int replicate) {
+        runReplicate(returns, replicate, workspaces[thread]);
+    });
+
+    persistence.assign(numPairs, 0);
+    for (int t = 0; t < threads; t++) 
+        for (long p = 0; p < numPairs; p++) persistence[p] += workspaces[t].edgeCount[p];
+    for (long p = 0; p < numPairs; p++) persistence[p] /= numReplicates;
+
+    runTime = Util::getWallTime() - startTime;
+}
+
+// Circular block bootstrap: blocks of blockLength consecutive periods (wrapping around) 
+// starting at uniform periods, until T periods are drawn
+void Bootstrap::runReplicate(const Returns &returns, int replicate, Workspace &ws) {
+    CounterRNG rng(seed, replicate);
+    int T = returns.getNumPeriods();
+    
+    ws.weights.assign(T, 0.0);
+    for (int drawn = 0; drawn < T; ) {
+        int start = rng.uniformInt(T);
+        for (int k = 0; k < blockLength && drawn < T; k++, drawn++) ws.weights[(start + k) % T] += 1;
+    }
+    computeTree(returns, ws);
+
+    TreeIndices indices = AlgoUtil::treeIndices(numAssets, ws.tree, ws.degree);
+    assortativity[replicate] = indices.assortativity;
+    randic       [replicate] = indices.randic;
+    
+    int N = numAssets;
+    for (unsigned e = 0; e < ws.tree.size(); e++) {
+        int i = ws.tree[e].u;
+        int j = ws.tree[e].v;
+        ws.edgeCount[(long)i * (2*N - i - 1) / 2 + (j - i - 1)]++;
+    }
+}
+
+void Bootstrap::computeTree(const Returns &returns, Workspace &ws) {
+    int N = numAssets;
+    ws.mean .resize(N);
+    ws.scale.resize(N);
+    returns.getWeightedMoments(&ws.weights[0], &ws.mean[0], &ws.scale[0]);
+    
+    ws.distance.resize((long)N * N);
+    for (int i = 0; i < N; i++) {
+        ws.distance[(long)i * N + i] = 0;
+        for (int j = i + 1; j < N; j++) {
+            double rho = returns.getWeightedCorrelation(i, j, &ws.weights[0], &ws.mean[0], &ws.scale[0]);
+            ws.distance[(long)i * N + j] = ws.distance[(long)j * N + i] = sqrt(2 * (1 - rho));
+        }
+    }
+    AlgoUtil::primDense(N, &ws.distance[0], ws.tree, ws.primBuffer);
+}
+
+double Bootstrap::getPersistence(int i, int j) const {
+    if (i == j) return 0;
+    if (i > j) std::swap(i, j);
+    int N = numAssets;
+    return persistence[(long)i * (2*N - i - 1) / 2 + (j - i - 1)];
+}
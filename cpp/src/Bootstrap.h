@@ -0,0 +1,74 @@
+/**
+ * Bootstrap.h
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef BOOTSTRAP_H
+#define BOOTSTRAP_H
+
+#include "Util.h"
+#include "AlgoUtil.h"
+
+class Returns;
+
+/**
+ * Stability of the minimum spanning tree of a window of returns under a
+ * circular block bootstrap. A replicate is a multiplicity per period, and its 
+ * correlations are weighted dot products of the standardised columns of 
+ * Returns, so the returns are never copied. Every replicate records its tree 
+ * edges and its degree indices. Replicates run in parallel; replicate r draws 
+ * from its own counter-based stream, so results do not depend on the number 
+ * of threads.
+ */
+class Bootstrap {
+
+    private:
+
+        struct Workspace {
+            vector<double>  weights;
+            vector<double>  mean;
+            vector<double>  scale;
+            vector<double>  distance;
+            vector<double>  primBuffer;
+            vector<MSTEdge> tree;
+            vector<int>     degree;
+            vector<int>     edgeCount; // diagonal, replicates containing (i, j)
+        };
+
+        int numReplicates;
+        int blockLength;
+        unsigned long long seed;
+        int threads;
+
+        int numAssets;
+        vector<MSTEdge> tree;        // of the original sample
+        TreeIndices     treeIndices;
+        vector<double>  persistence; // diagonal, fraction of replicates containing (i, j)
+        vector<double>  assortativity;
+        vector<double>  randic;
+
+        double runTime;
+
+        void runReplicate(const Returns &returns, int replicate, Workspace &ws);
+        void computeTree(const Returns &returns, Workspace &ws);
+
+    public:
+
+        Bootstrap();
+        ~Bootstrap();
+
+        void setParameters(int numReplicates, int blockLength, unsigned long long seed, int threads);
+        void run(const Returns &returns);
+
+        const vector<MSTEdge> &getTree()          const { return tree;          }
+        const TreeIndices     &getTreeIndices()   const { return treeIndices;   }
+        const vector<double>  &getAssortativity() const { return assortativity; }
+        const vector<double>  &getRandic()        const { return randic;        }
+        double getPersistence(int i, int j) const;
+        double getRunTime() const { return runTime; }
+};
+
+#endif
@@ -37,6 +37,12 @@ CPLEX::CPLEX() : Solver() {
     status = 0;
     problem = CPXcreateprob(env, &status, "");
     Check(status, env);
+
+    genericContexts = 0;
+    useGenericCallbacks = Options::getInstance()->getStringOption("callback_api").compare("generic") == 0;
+#if CPX_VERSION < 12080000
+    if (useGenericCallbacks) Util::throwInvalidArgument("Error: The generic callback API requires CPLEX 12.8 or later.");
+#endif
 }
 
 CPLEX::~CPLEX() {
@@ -64,6 +70,18 @@ int CPLEX::getNumCols() {
     return CPXgetnumcols(env, problem); 
 }
 
+int CPLEX::getPresolvedNumRows() { 
+    CPXCLPptr reduced = NULL;
+    if (CPXgetredlp(env, problem, &reduced) != 0 || reduced == NULL) return -1;
+    return CPXgetnumrows(env, reduced); 
+}
+
+int CPLEX::getPresolvedNumCols() { 
+    CPXCLPptr reduced = NULL;
+    if (CPXgetredlp(env, problem, &reduced) != 0 || reduced == NULL) return -1;
+    return CPXgetnumcols(env, reduced); 
+}
+
 void CPLEX::changeObjectiveSense(bool isMax) {
     CPXchgobjsen(env, problem, isMax ? -1 : 1); 
 }
@@ -315,6 +333,10 @@ int CPLEX::getStatus() {
     return status; 
 }
 
+bool CPLEX::isMaximisation() { 
+    return CPXgetobjsen(env, problem) == CPX_MAX; 
+}
+
 double CPLEX::getObjValue() {
     double objValue = 0;
     Check(CPXgetobjval(env, problem, &objValue), env);
@@ -365,6 +387,24 @@ void CPLEX::setNodeLimit(int lim) {
     }
 }
 
+void CPLEX::setThreads(int threads) {
+    if (threads > 0) {
+        Check(CPXsetintparam(env, CPX_PARAM_THREADS, threads), env);
+    }
+}
+
+void CPLEX::setParallelMode(int mode) {
+    if      (mode == -1) Check(CPXsetintparam(env, CPX_PARAM_PARALLELMODE, CPX_PARALLEL_OPPORTUNISTIC), env);
+    else if (mode ==  0) Check(CPXsetintparam(env, CPX_PARAM_PARALLELMODE, CPX_PARALLEL_AUTO), env);
+    else if (mode ==  1) Check(CPXsetintparam(env, CPX_PARAM_PARALLELMODE, CPX_PARALLEL_DETERMINISTIC), env);
+}
+
+void CPLEX::setObjectiveCutoff(double cutoff) {
+    // Lower cutoff for maximisation, upper cutoff for minimisation
+    int sense = CPXgetobjsen(env, problem);
+    Check(CPXsetdblparam(env, sense == CPX_MAX ? CPX_PARAM_CUTLO : CPX_PARAM_CUTUP, cutoff), env);
+}
+
 
 void CPLEX::setLPTolerance(double tolerance) {
     Check(CPXsetdblparam(env, CPX_PARAM_EPRHS, tolerance));
@@ -535,7 +575,21 @@ bool CPLEX::isNumericalDifficulties() {
 
 
 
+void CPLEX::installGenericCallback(CPXLONG context, void* userData) {
+#if CPX_VERSION >= 12080000
+    // A single function serves every context, so the mask accumulates
+    genericContexts |= context;
+    Check(CPXcallbacksetfunc(env, problem, genericContexts, genericCallback, userData), env);
+#endif
+}
+
 void CPLEX::addLazyCallback(void* userData) {
+#if CPX_VERSION >= 12080000
+    if (useGenericCallbacks) {
+        installGenericCallback(CPX_CALLBACKCONTEXT_CANDIDATE, userData);
+        return;
+    }
+#endif
     // Ask for variables in terms of original problem instead of presolved.
     Check(CPXsetintparam(env, CPX_PARAM_MIPCBREDLP, CPX_OFF), env);
     Check(CPXsetintparam(env, CPX_PARAM_PRELINEAR, CPX_OFF), env);
@@ -543,6 +597,12 @@ void CPLEX::addLazyCallback(void* userData) {
 }
 
 void CPLEX::addUserCutCallback(void* userData) {
+#if CPX_VERSION >= 12080000
+    if (useGenericCallbacks) {
+        installGenericCallback(CPX_CALLBACKCONTEXT_RELAXATION, userData);
+        return;
+    }
+#endif
     // Ask for variables in terms of original problem instead of presolved.
     Check(CPXsetintparam(env, CPX_PARAM_MIPCBREDLP, CPX_OFF), env);
     Check(CPXsetintparam(env, CPX_PARAM_PRELINEAR, CPX_OFF), env);
@@ -550,32 +610,76 @@ void CPLEX::addUserCutCallback(void* userData) {
 }
 
 void CPLEX::addIncumbentCallback(void* userData) {
+#if CPX_VERSION >= 12080000
+    if (useGenericCallbacks) {
+        installGenericCallback(CPX_CALLBACKCONTEXT_GLOBAL_PROGRESS, userData);
+        return;
+    }
+#endif
     Check(CPXsetincumbentcallbackfunc(env, incumbentCallback, userData), env);
 }
 
 void CPLEX::addNodeCallback(void* userData) {
+#if CPX_VERSION >= 12080000
+    if (useGenericCallbacks) {
+        installGenericCallback(CPX_CALLBACKCONTEXT_GLOBAL_PROGRESS, userData);
+        return;
+    }
+#endif
     Check(CPXsetnodecallbackfunc(env, nodeCallback, userData), env);
 }
 
+void CPLEX::addInfoCallback(void* userData) {
+#if CPX_VERSION >= 12080000
+    // Legacy and generic callbacks cannot be mixed
+    if (useGenericCallbacks) {
+        installGenericCallback(CPX_CALLBACKCONTEXT_GLOBAL_PROGRESS, userData);
+        return;
+    }
+#endif
+    Check(CPXsetinfocallbackfunc(env, infoCallback, userData), env);
+}
+
 
 int CPXPUBLIC CPLEX::functionCallback(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle, int* useraction_p) {
 
     Model* model = static_cast<Model*>(cbhandle);
+
+    if (model->getSolver()->getProgress()->isCancelRequested()) {
+        *useraction_p = CPX_CALLBACK_FAIL;
+        return 0;
+    }
     
-    int numCols = model->getSolver()->getNumCols();
+    int thread = 0;
+    int status = CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_MY_THREAD_NUM, &thread);
+    if (status != 0 || thread < 0 || thread >= model->getNumThreads()) {
+        printf("Error in functionCallback, invalid thread %d (status = %d)\n", thread, status);
+        return 1;
+    }
+
+    int numCols = model->getSolver()->getNumColsInSolve();
     vector<double> x(numCols);
-    int status = CPXgetcallbacknodex(env, cbdata, wherefrom, &x[0], 0, numCols-1);
+    status = CPXgetcallbacknodex(env, cbdata, wherefrom, &x[0], 0, numCols-1);
     if (status != 0) {
         printf("Error in functionCallback, status = %d\n", status);
         return 0;
     }
     
-    vector<SolverCut> cuts = model->separationAlgorithm(x);
+    SeparationContext separation;
+    separation.thread    = thread;
+    separation.candidate = (wherefrom == CPX_CALLBACK_MIP_CUT_FEAS);
+    CPXLONG node      = -1;
+    CPXgetcallbacknodeinfo(env, cbdata, wherefrom, 0, CPX_CALLBACK_INFO_NODE_DEPTH, &separation.depth);
+    CPXgetcallbacknodeinfo(env, cbdata, wherefrom, 0, CPX_CALLBACK_INFO_NODE_SEQNUM_LONG, &node);
+    CPXgetcallbacknodeobjval(env, cbdata, wherefrom, &separation.nodeBound);
+    separation.node = (long)node;
+    
+    vector<SolverCut> cuts = model->separationAlgorithm(x, separation);
     for (int i  = 0; i < (int)cuts.size(); i++) {
         vector<int> indices  = cuts[i].getIndices();
         vector<double> coefs = cuts[i].getCoefs();
         CPXcutcallbackadd(env, cbdata, wherefrom, (int)cuts[i].getNumCoefs(), cuts[i].getRHS(), 
-                          cuts[i].getSense(), &indices[0], &coefs[0], CPX_USECUT_FORCE);
+                          cuts[i].getSense(), &indices[0], &coefs[0], cuts[i].isPurgeable() ? CPX_USECUT_PURGE : CPX_USECUT_FORCE);
     }
 
     
@@ -594,6 +698,7 @@ int CPXPUBLIC CPLEX::functionCallback(CPXCENVptr env, void* cbdata, int wherefro
 int CPXPUBLIC CPLEX::incumbentCallback(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle, double objval, 
                                        double *x, int *isfeas_p, int* useraction_p) {
     Model* model = static_cast<Model*>(cbhandle);
+    model->getSolver()->getProgress()->updateIncumbent(objval);
     model->incumbentCallbackFunction();
     return 0;
 }
@@ -605,7 +710,130 @@ int CPXPUBLIC CPLEX::nodeCallback(CPXCENVptr env, void* cbdata, int wherefrom, v
     double value;
     CPXgetcallbacknodeinfo(env, cbdata, wherefrom, 0, CPX_CALLBACK_INFO_NODE_OBJVAL, &value);
     model->nodeCallbackFunction(value);
+
+    SolveProgress* progress = model->getSolver()->getProgress();
+    double bound;
+    int nodes;
+    if (CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_BEST_REMAINING, &bound) == 0) progress->setBestBound(bound);
+    if (CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_NODE_COUNT,     &nodes) == 0) progress->setNodeCount(nodes);
+    if (progress->isCancelRequested()) *useraction_p = CPX_CALLBACK_FAIL;
     return 0;
 }
 
+// A nonzero return value terminates the optimisation (status CPXMIP_ABORT_FEAS)
+int CPXPUBLIC CPLEX::infoCallback(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle) {
 
+    Model* model = static_cast<Model*>(cbhandle);
+
+    int hasIncumbent = 0;
+    int nodes        = 0;
+    double incumbent = 0;
+    double bound     = 0;
+    CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_MIP_FEAS, &hasIncumbent);
+    if (hasIncumbent) CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_BEST_INTEGER, &incumbent);
+    CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_BEST_REMAINING, &bound);
+    CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_NODE_COUNT, &nodes);
+
+    SolveProgress* progress = model->getSolver()->getProgress();
+    if (hasIncumbent) progress->updateIncumbent(incumbent);
+    progress->setBestBound(bound);
+    progress->setNodeCount(nodes);
+
+    // Root node is done as soon as the first branch is processed
+    if (nodes > 0) model->nodeCallbackFunction(bound);
+    if (progress->isCancelRequested()) return 1;
+    return model->infoCallbackFunction(hasIncumbent != 0, incumbent, bound);
+}
+
+
+#if CPX_VERSION >= 12080000
+int CPXPUBLIC CPLEX::genericCallback(CPXCALLBACKCONTEXTptr context, CPXLONG contextId, void* cbhandle) {
+    
+    Model* model = static_cast<Model*>(cbhandle);
+    
+    if (contextId == CPX_CALLBACKCONTEXT_GLOBAL_PROGRESS) {
+        CPXLONG nodes    = 0;
+        double incumbent = 0;
+        double bound     = 0;
+        CPXcallbackgetinfolong(context, CPXCALLBACKINFO_NODECOUNT, &nodes);
+        CPXcallbackgetinfodbl(context, CPXCALLBACKINFO_BEST_SOL, &incumbent);
+        CPXcallbackgetinfodbl(context, CPXCALLBACKINFO_BEST_BND, &bound);
+        
+        // Without an incumbent BEST_SOL is +-infinity
+        bool hasIncumbent = fabs(incumbent) < 1e75;
+        SolveProgress* progress = model->getSolver()->getProgress();
+        if (hasIncumbent) progress->updateIncumbent(incumbent);
+        progress->setBestBound(bound);
+        progress->setNodeCount((long)nodes);
+
+        if (nodes > 0) model->nodeCallbackFunction(bound);
+        if (progress->isCancelRequested() || model->infoCallbackFunction(hasIncumbent, incumbent, bound)) CPXcallbackabort(context);
+        return 0;
+    }
+
+    if (model->getSolver()->getProgress()->isCancelRequested()) {
+        CPXcallbackabort(context);
+        return 0;
+    }
+
+    CPXINT thread = 0;
+    int status = CPXcallbackgetinfoint(context, CPXCALLBACKINFO_THREADID, &thread);
+    if (status != 0 || thread < 0 || thread >= model->getNumThreads()) {
+        printf("Error in genericCallback, invalid thread %d (status = %d)\n", thread, status);
+        return 1;
+    }
+
+    // Points are always given in the original space
+    int numCols = model->getSolver()->getNumColsInSolve();
+    vector<double> x(numCols);
+    double objective;
+    if (contextId == CPX_CALLBACKCONTEXT_CANDIDATE) status = CPXcallbackgetcandidatepoint (context, &x[0], 0, numCols-1, &objective);
+    else                                            status = CPXcallbackgetrelaxationpoint(context, &x[0], 0, numCols-1, &objective);
+    if (status != 0) {
+        printf("Error in genericCallback, status = %d\n", status);
+        return 0;
+    }
+
+    SeparationContext separation;
+    separation.thread    = thread;
+    separation.candidate = (contextId == CPX_CALLBACKCONTEXT_CANDIDATE);
+    separation.nodeBound = objective;
+    CPXLONG depth     = -1;
+    CPXLONG node      = -1;
+    CPXcallbackgetinfolong(context, CPXCALLBACKINFO_NODEDEPTH, &depth);
+    CPXcallbackgetinfolong(context, CPXCALLBACKINFO_NODEUID, &node);
+    separation.depth = (int)depth;
+    separation.node  = (long)node;
+
+    vector<SolverCut> cuts = model->separationAlgorithm(x, separation);
+    if (cuts.size() == 0) return 0;
+
+    vector<double> rhs;
+    vector<char>   sense;
+    vector<int>    begin;
+    vector<int>    indices;
+    vector<double> coefs;
+    for (int i  = 0; i < (int)cuts.size(); i++) {
+        rhs.push_back(cuts[i].getRHS());
+        sense.push_back(cuts[i].getSense());
+        begin.push_back((int)indices.size());
+        vector<int>    ind = cuts[i].getIndices();
+        vector<double> cof = cuts[i].getCoefs();
+        indices.insert(indices.end(), ind.begin(), ind.end());
+        coefs.insert(coefs.end(), cof.begin(), cof.end());
+    }
+
+    int numCuts = (int)cuts.size();
+    if (contextId == CPX_CALLBACKCONTEXT_CANDIDATE) {
+        status = CPXcallbackrejectcandidate(context, numCuts, (int)indices.size(), &rhs[0], &sense[0], &begin[0], &indices[0], &coefs[0]);
+    } else {
+        vector<int> purgeable(numCuts, CPX_USECUT_FORCE);
+        for (int i = 0; i < numCuts; i++) if (cuts[i].isPurgeable()) purgeable[i] = CPX_USECUT_PURGE;
+        vector<int> local(numCuts, 0);
+        status = CPXcallbackaddusercuts(context, numCuts, (int)indices.size(), &rhs[0], &sense[0], &begin[0], &indices[0], &coefs[0], 
+                                        &purgeable[0], &local[0]);
+    }
+    if (status != 0) printf("Error in genericCallback when adding cuts, status = %d\n", status);
+    return 0;
+}
+#endif
@@ -29,7 +29,16 @@ class CPLEX : public Solver {
         static int CPXPUBLIC incumbentCallback(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle, double objval, 
                                                double *x, int *isfeas_p, int* useraction_p);
         static int CPXPUBLIC nodeCallback(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle, int* nodeindex_p, int* useraction_p);
+        static int CPXPUBLIC infoCallback(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle);
 
+        // Generic callback API (CPLEX 12.8 onwards): callbacks see the original space and CPLEX
+        // maps cuts into the presolved problem, so presolve does not have to be restricted
+        bool useGenericCallbacks;
+        CPXLONG genericContexts;
+        void installGenericCallback(CPXLONG context, void* userData);
+#if CPX_VERSION >= 12080000
+        static int CPXPUBLIC genericCallback(CPXCALLBACKCONTEXTptr context, CPXLONG contextId, void* cbhandle);
+#endif
 
 
     public:
@@ -67,7 +76,10 @@ class CPLEX : public Solver {
         // Get data
         virtual int getNumCols();
         virtual int getNumRows();
+        virtual int getPresolvedNumCols();
+        virtual int getPresolvedNumRows();
         virtual int getStatus();
+        virtual bool isMaximisation();
         virtual double getObjValue();
         virtual double getBestBound();
         virtual void getColSolution();
@@ -78,6 +90,9 @@ class CPLEX : public Solver {
         // Params
         virtual void setTimeLimit(double time);
         virtual void setNodeLimit(int lim);
+        virtual void setObjectiveCutoff(double cutoff);
+        virtual void setThreads(int threads);
+        virtual void setParallelMode(int mode);
         virtual void enablePresolve(bool enable = true);
 
         virtual void setLPMethod();
@@ -118,6 +133,7 @@ class CPLEX : public Solver {
         virtual void addUserCutCallback(void* userData);
         virtual void addIncumbentCallback(void* userData);
         virtual void addNodeCallback(void* userData);
+        virtual void addInfoCallback(void* userData);
         
 };    
 
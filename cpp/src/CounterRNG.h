@@ -0,0 +1,58 @@
+/**
+ * CounterRNG.h
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef COUNTERRNG_H
+#define COUNTERRNG_H
+
+/**
+ * Counter-based random numbers: the n-th number of stream s under a seed is
+ * a hash of (seed, s, n), so any stream can be started anywhere without
+ * state. Giving each Monte Carlo iteration its own stream makes the results
+ * independent of how iterations are split among threads. The hash is the
+ * SplitMix64 finaliser.
+ */
+class CounterRNG {
+
+    private:
+
+        unsigned long long key;
+        unsigned long long counter;
+
+        static unsigned long long mix(unsigned long long z) {
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+    public:
+
+        CounterRNG(unsigned long long seed = 0, unsigned long long stream = 0) {
+            setStream(seed, stream);
+        }
+
+        void setStream(unsigned long long seed, unsigned long long stream) {
+            key     = mix(mix(seed + 0x9e3779b97f4a7c15ULL) ^ (stream * 0xd1b54a32d192ed03ULL));
+            counter = 0;
+        }
+
+        unsigned long long next() {
+            return mix(key + 0x9e3779b97f4a7c15ULL * ++counter);
+        }
+
+        // Uniform in [0, 1)
+        double uniform() {
+            return (next() >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        // Uniform integer in [0, n), by multiply-shift (bias below 2^-32 for the sizes used here)
+        int uniformInt(int n) {
+            return (int)(((next() >> 32) * (unsigned long long)n) >> 32);
+        }
+};
+
+#endif
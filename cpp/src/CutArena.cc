@@ -0,0 +1,141 @@
+/**
+ * CutArena.cc
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "CutArena.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CUT_ARENA_X86
+#include <immintrin.h>
+#endif
+
+// lhs[c] = sum_k coef[k] * x[index[k]] for k in [begin[c], begin[c+1])
+typedef void (*LhsKernel)(const int* begin, int numCuts, const int* index, const double* coef, const double* x, double* lhs);
+
+static void lhsScalar(const int* begin, int numCuts, const int* index, const double* coef, const double* x, double* lhs) {
+    for (int c = 0; c < numCuts; c++) {
+        double sum = 0;
+        for (int k = begin[c]; k < begin[c+1]; k++) sum += coef[k] * x[index[k]];
+        lhs[c] = sum;
+    }
+}
+
+#ifdef CUT_ARENA_X86
+__attribute__((target("avx2")))
+static void lhsAVX2(const int* begin, int numCuts, const int* index, const double* coef, const double* x, double* lhs) {
+    for (int c = 0; c < numCuts; c++) {
+        int k   = begin[c];
+        int end = begin[c+1];
+        __m256d acc = _mm256_setzero_pd();
+        // Masked gather with a zeroed source: the unmasked one reads an uninitialised source
+        __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        for (; k + 4 <= end; k += 4) {
+            __m128i vi = _mm_loadu_si128((const __m128i*)(index + k));
+            __m256d vx = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, vi, all, 8);
+            acc = _mm256_add_pd(acc, _mm256_mul_pd(vx, _mm256_loadu_pd(coef + k)));
+        }
+        __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+        double sum = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+        for (; k < end; k++) sum += coef[k] * x[index[k]];
+        lhs[c] = sum;
+    }
+}
+
+__attribute__((target("avx512f")))
+static void lhsAVX512(const int* begin, int numCuts, const int* index, const double* coef, const double* x, double* lhs) {
+    for (int c = 0; c < numCuts; c++) {
+        int k   = begin[c];
+        int end = begin[c+1];
+        __m512d acc = _mm512_setzero_pd();
+        for (; k + 8 <= end; k += 8) {
+            __m256i vi = _mm256_loadu_si256((const __m256i*)(index + k));
+            __m512d vx = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, vi, x, 8);
+            acc = _mm512_add_pd(acc, _mm512_mul_pd(vx, _mm512_loadu_pd(coef + k)));
+        }
+        // Reduced through memory, _mm512_reduce_add_pd extracts from an undefined source as well
+        double lanes[8];
+        _mm512_storeu_pd(lanes, acc);
+        double sum = ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+        for (; k < end; k++) sum += coef[k] * x[index[k]];
+        lhs[c] = sum;
+    }
+}
+#endif
+
+static LhsKernel selectKernel(const char** name) {
+#ifdef CUT_ARENA_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) { *name = "avx512"; return lhsAVX512; }
+    if (__builtin_cpu_supports("avx2"))    { *name = "avx2";   return lhsAVX2;   }
+#endif
+    *name = "scalar";
+    return lhsScalar;
+}
+
+static const char* kernelName = "";
+static LhsKernel   kernel     = selectKernel(&kernelName);
+
+
+CutArena::CutArena() {
+    begin.push_back(0);
+}
+
+CutArena::~CutArena() {
+}
+
+void CutArena::clear() {
+    begin.resize(1);
+    indices.clear();
+    coefs.clear();
+    rhs.clear();
+    sense.clear();
+}
+
+void CutArena::open(char s, double r) {
+    sense.push_back(s);
+    rhs.push_back(r);
+}
+
+int CutArena::close() {
+    begin.push_back((int)indices.size());
+    return (int)rhs.size() - 1;
+}
+
+void CutArena::discard() {
+    indices.resize(begin.back());
+    coefs.resize(begin.back());
+    rhs.pop_back();
+    sense.pop_back();
+}
+
+void CutArena::evaluate(const vector<double> &sol, vector<double> &violations) {
+    int numCuts = getNumCuts();
+    violations.resize(numCuts);
+    if (numCuts == 0) return;
+    
+    lhs.resize(numCuts);
+    kernel(&begin[0], numCuts, indices.data(), coefs.data(), sol.data(), &lhs[0]);
+    
+    for (int c = 0; c < numCuts; c++) {
+        double v = lhs[c] - rhs[c];
+        if      (sense[c] == 'G') v = -v;
+        else if (sense[c] == 'E') v = fabs(v);
+        violations[c] = v;
+    }
+}
+
+SolverCut CutArena::getCut(int c) const {
+    SolverCut cut;
+    cut.setSense(sense[c]);
+    cut.setRHS(rhs[c]);
+    for (int k = begin[c]; k < begin[c+1]; k++) cut.addCoef(indices[k], coefs[k]);
+    return cut;
+}
+
+const char* CutArena::getKernelName() {
+    return kernelName;
+}
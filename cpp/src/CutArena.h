@@ -0,0 +1,59 @@
+/**
+ * CutArena.h
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef CUTARENA_H
+#define CUTARENA_H
+
+#include "Util.h"
+#include "Solver.h"
+
+/**
+ * Candidate cuts stored back to back: the coefficients of cut c are 
+ * indices/coefs[begin[c]..begin[c+1]). Cuts are assembled in place (open, 
+ * addCoef, close or discard) and only those that are kept become SolverCuts.
+ *
+ * evaluate computes the violations of all cuts in one pass, with AVX-512 or
+ * AVX2 gathers when the processor has them (checked once at run time) and
+ * a scalar loop otherwise.
+ */
+class CutArena {
+
+    private:
+
+        vector<int>    begin;
+        vector<int>    indices;
+        vector<double> coefs;
+        vector<double> rhs;
+        vector<char>   sense;
+        vector<double> lhs;
+
+    public:
+
+        CutArena();
+        ~CutArena();
+
+        void clear();
+
+        void open(char sense, double rhs);
+        void addCoef(int index, double coef) { indices.push_back(index); coefs.push_back(coef); }
+        // Returns the index of the cut
+        int  close();
+        void discard();
+
+        // Positive entries are violated cuts
+        void evaluate(const vector<double> &sol, vector<double> &violations);
+        
+        SolverCut getCut(int c) const;
+        int getNumCuts()  const { return (int)rhs.size(); }
+        int getNumCoefs() const { return (int)indices.size(); }
+
+        // Name of the evaluation kernel used on this processor
+        static const char* getKernelName();
+};
+
+#endif
@@ -0,0 +1,187 @@
+/**
+ * CutPool.cc
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "CutPool.h"
+
+// A cut added less than CUT_POOL_AGE select calls ago is a duplicate; after that 
+// it may have been purged, and being violated again it is sent again
+#define CUT_POOL_AGE      1000
+#define CUT_POOL_CAPACITY 200000
+
+// Cuts with at least this fraction of the best efficacy are forced into the LP
+#define CUT_POOL_FORCE    0.5
+
+CutPool::CutPool() {
+    numEntries = 0;
+    tick = 0;
+    initialise(10, 0.9);
+}
+
+CutPool::~CutPool() {
+}
+
+void CutPool::initialise(int maxCuts, double maxParallelism) {
+    this->maxCuts        = maxCuts;
+    this->maxParallelism = maxParallelism;
+    ageWindow = CUT_POOL_AGE;
+    capacity  = CUT_POOL_CAPACITY;
+    clear();
+}
+
+void CutPool::clear() {
+    entries.clear();
+    numEntries = 0;
+    tick = 0;
+}
+
+SolverCut CutPool::normalise(SolverCut &cut) {
+    vector<int>    indices = cut.getIndices();
+    vector<double> coefs   = cut.getCoefs();
+    vector<int> order(indices.size());
+    for (unsigned i = 0; i < order.size(); i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return indices[a] < indices[b]; });
+    
+    SolverCut normalised;
+    normalised.setSense(cut.getSense());
+    normalised.setRHS(cut.getRHS());
+    for (unsigned i = 0; i < order.size(); i++) normalised.addCoef(indices[order[i]], coefs[order[i]]);
+    return normalised;
+}
+
+// FNV-1a over the indices, coefficients, rhs and sense
+unsigned long long CutPool::hash(SolverCut &cut) {
+    unsigned long long h = 14695981039346656037ULL;
+    vector<int>    indices = cut.getIndices();
+    vector<double> coefs   = cut.getCoefs();
+    for (unsigned i = 0; i < indices.size(); i++) {
+        h = (h ^ (unsigned long long)indices[i]) * 1099511628211ULL;
+        h = (h ^ (unsigned long long)(long long)round(coefs[i] * 1e6)) * 1099511628211ULL;
+    }
+    h = (h ^ (unsigned long long)(long long)round(cut.getRHS() * 1e6)) * 1099511628211ULL;
+    h = (h ^ (unsigned long long)cut.getSense()) * 1099511628211ULL;
+    return h;
+}
+
+double CutPool::norm(SolverCut &cut) {
+    vector<double> coefs = cut.getCoefs();
+    double n = 0;
+    for (unsigned i = 0; i < coefs.size(); i++) n += coefs[i] * coefs[i];
+    return sqrt(n);
+}
+
+double CutPool::parallelism(SolverCut &a, double normA, SolverCut &b, double normB) {
+    if (normA <= 0 || normB <= 0) return 0;
+    vector<int>    ia = a.getIndices();
+    vector<int>    ib = b.getIndices();
+    vector<double> ca = a.getCoefs();
+    vector<double> cb = b.getCoefs();
+    
+    double dot = 0;
+    unsigned i = 0;
+    unsigned j = 0;
+    while (i < ia.size() && j < ib.size()) {
+        if      (ia[i] < ib[j]) i++;
+        else if (ia[i] > ib[j]) j++;
+        else dot += ca[i++] * cb[j++];
+    }
+    return dot / (normA * normB);
+}
+
+bool CutPool::wasAddedRecently(SolverCut &cut, unsigned long long key) {
+    vector<Entry> &bucket = entries[key];
+    for (unsigned e = 0; e < bucket.size(); e++) {
+        if (!bucket[e].cut.hasSameVariables(cut)) continue;
+        vector<double> a = bucket[e].cut.getCoefs();
+        vector<double> b = cut.getCoefs();
+        if (a != b || bucket[e].cut.getRHS() != cut.getRHS() || bucket[e].cut.getSense() != cut.getSense()) continue;
+
+        bool recent = tick - bucket[e].lastAdded < ageWindow;
+        if (!recent) bucket[e].lastAdded = tick;
+        return recent;
+    }
+    
+    Entry entry;
+    entry.cut       = cut;
+    entry.lastAdded = tick;
+    bucket.push_back(entry);
+    numEntries++;
+    return false;
+}
+
+// Drops the entries that have not been added for a while
+void CutPool::evictOld() {
+    for (auto it = entries.begin(); it != entries.end(); ) {
+        vector<Entry> &bucket = it->second;
+        for (unsigned e = 0; e < bucket.size(); ) {
+            if (tick - bucket[e].lastAdded >= ageWindow) {
+                bucket[e] = bucket.back();
+                bucket.pop_back();
+                numEntries--;
+            } else e++;
+        }
+        if (bucket.size() == 0) it = entries.erase(it);
+        else it++;
+    }
+}
+
+vector<SolverCut> CutPool::select(vector<SolverCut> &candidates, const vector<double> &sol, bool candidate, int &duplicates) {
+
+    duplicates = 0;
+    vector<SolverCut> selected;
+    if (candidates.size() == 0) return selected;
+
+    // Ranked by efficacy
+    int n = (int)candidates.size();
+    vector<SolverCut> normalised(n);
+    vector<double> norms(n);
+    vector<std::pair<int, double>> efficacy(n);
+    for (int i = 0; i < n; i++) {
+        normalised[i] = normalise(candidates[i]);
+        norms[i]      = norm(normalised[i]);
+        efficacy[i]   = std::make_pair(i, norms[i] > 0 ? normalised[i].violation(sol) / norms[i] : 0);
+    }
+    std::sort(efficacy.begin(), efficacy.end(), Util::sortPairDesc<int, double>());
+    double bestEfficacy = efficacy[0].second;
+
+    vector<int> accepted;
+    tick++;
+    
+    for (int r = 0; r < n; r++) {
+        int i = efficacy[r].first;
+        unsigned long long key = hash(normalised[i]);
+
+        if (candidate) {
+            // Every violated cut is kept, the pool only learns about it
+            wasAddedRecently(normalised[i], key);
+            candidates[i].setPurgeable(false);
+            selected.push_back(candidates[i]);
+            continue;
+        }
+        
+        if (maxCuts > 0 && (int)accepted.size() >= maxCuts) break;
+
+        bool parallel = false;
+        for (unsigned a = 0; a < accepted.size() && !parallel; a++) {
+            int j = accepted[a];
+            if (parallelism(normalised[i], norms[i], normalised[j], norms[j]) > maxParallelism) parallel = true;
+        }
+        if (parallel) continue;
+        
+        if (wasAddedRecently(normalised[i], key)) {
+            duplicates++;
+            continue;
+        }
+
+        accepted.push_back(i);
+        candidates[i].setPurgeable(efficacy[r].second < CUT_POOL_FORCE * bestEfficacy);
+        selected.push_back(candidates[i]);
+    }
+
+    if (numEntries > capacity) evictOld();
+    return selected;
+}
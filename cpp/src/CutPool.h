@@ -0,0 +1,72 @@
+/**
+ * CutPool.h
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef CUTPOOL_H
+#define CUTPOOL_H
+
+#include <unordered_map>
+#include "Util.h"
+#include "Solver.h"
+
+/**
+ * Cuts added to the solver by one thread. Each cut is normalised (indices 
+ * sorted) and hashed, so that a cut found again shortly after it was added,
+ * e.g. at a sibling node, is not sent twice. There is one pool per thread: a 
+ * shared one would drop cuts depending on which thread reached it first, and 
+ * the cuts sent would change between runs of the deterministic parallel mode.
+ *
+ * At fractional points the candidates are ranked by efficacy, the violation 
+ * divided by the norm of the coefficients, and accepted greedily unless they 
+ * are too parallel to a cut already accepted, up to maxCuts. The strongest are
+ * forced into the LP, the others may be purged by the solver. Candidates at
+ * integer points are never dropped, as the solution would be accepted.
+ */
+class CutPool {
+
+    private:
+
+        struct Entry {
+            SolverCut cut;
+            long      lastAdded;
+        };
+
+        std::unordered_map<unsigned long long, vector<Entry>> entries;
+        int  numEntries;
+        long tick;
+
+        int    maxCuts;
+        double maxParallelism;
+        long   ageWindow;
+        int    capacity;
+
+        static SolverCut normalise(SolverCut &cut);
+        static unsigned long long hash(SolverCut &cut);
+        static double norm(SolverCut &cut);
+        // Cosine of the angle between two normalised cuts
+        static double parallelism(SolverCut &a, double normA, SolverCut &b, double normB);
+
+        // Returns true if the cut was added less than ageWindow calls ago, records it otherwise
+        bool wasAddedRecently(SolverCut &cut, unsigned long long key);
+        void evictOld();
+
+    public:
+
+        CutPool();
+        ~CutPool();
+
+        void initialise(int maxCuts, double maxParallelism);
+        void clear();
+        
+        // Returns the cuts to be added, with their purgeable flag set. duplicates
+        // counts the candidates dropped because they were already in the pool
+        vector<SolverCut> select(vector<SolverCut> &candidates, const vector<double> &sol, bool candidate, int &duplicates);
+
+        int getNumEntries() { return numEntries; }
+};
+
+#endif
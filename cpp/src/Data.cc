@@ -73,6 +73,18 @@ double Data::getCorrelation(int i, int j) const {
 }
 
 
+void Data::getDistanceMatrix(vector<double> &matrix) const {
+    int N = numAssets;
+    matrix.assign((long)N * N, 0);
+    for (int i = 0; i < N-1; i++) {
+        for (int j = i+1; j < N; j++) {
+            matrix[(long)i*N + j] = correlation[i][j - i - 1];
+            matrix[(long)j*N + i] = correlation[i][j - i - 1];
+        }
+    }
+}
+
+
 void Data::print() {
     int debug =  Options::getInstance()->getIntOption("debug");
     if (debug > 0) {
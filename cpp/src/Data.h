@@ -30,6 +30,9 @@ class Data {
         int getNumAssets() const {return numAssets;};
         
         double getCorrelation(int i, int j) const;
+        
+        // Full symmetric matrix of the values read (Mantegna distances), row-major with a zero diagonal
+        void getDistanceMatrix(vector<double> &matrix) const;
 
         void readData();
         void print();
@@ -0,0 +1,294 @@
+/**
+ * DynamicMST.cc
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "DynamicMST.h"
+
+
+DynamicMST::DynamicMST() {
+    n             = 0;
+    threads       = 1;
+    rebuildFactor = 1;
+    rebuilds      = 0;
+    cycleChecks   = 0;
+    cutChecks     = 0;
+    swaps         = 0;
+}
+
+DynamicMST::~DynamicMST() {
+}
+
+void DynamicMST::initialise(int n, const vector<double> &weights) {
+    if ((long)weights.size() < (long)n * n) 
+        Util::throwInvalidArgument("Error in DynamicMST: %d x %d weights expected, %d found.", n, n, (int)weights.size());
+    this->n = n;
+    this->weights.assign(weights.begin(), weights.begin() + (long)n * n);
+    previous.resize(n);
+    queue.resize(n);
+    side.resize(n);
+    subtree.resize(n);
+    upperWeight.resize(n);
+    rebuild();
+    rebuilds = 0;
+}
+
+void DynamicMST::rebuild() {
+    vector<MSTEdge> tree = AlgoUtil::minimumSpanningTree(n, weights, threads);
+    treeEdge.assign((long)n * n, 0);
+    adjacency.assign(n, vector<int>());
+    for (unsigned e = 0; e < tree.size(); e++) addTreeEdge(tree[e].u, tree[e].v);
+    rebuilds++;
+}
+
+
+// A cycle check costs about n operations and a cut check |A| n, A being the smaller side of the 
+// cut, against n^2 for a rebuild. Only non-tree edges that fall below their bottleneck need a cycle
+// check: the heaviest edge of their tree path, with every tree edge at the larger of its old and 
+// new weights. While the changes are applied the tree stays minimum for weights no larger than 
+// those, and the tree path of a minimum tree is a minimax path, so no path gets heavier than that.
+void DynamicMST::update(const vector<WeightChange> &changes) {
+    
+    computeSubtreeSizes();
+    for (int v = 1; v < n; v++) upperWeight[v] = w(v, previous[v]);
+    
+    double cost = 0;
+    int    decreases = 0;
+    for (unsigned c = 0; c < changes.size(); c++) {
+        int u = changes[c].u;
+        int v = changes[c].v;
+        if (u == v) continue;
+        if (treeEdge[(long)u * n + v]) {
+            int child = previous[v] == u ? v : u;
+            upperWeight[child] = std::max(upperWeight[child], changes[c].weight);
+            if (changes[c].weight > w(u, v)) cost += (double)std::min(subtree[child], n - subtree[child]) * n;
+        } 
+        else if (changes[c].weight < w(u, v)) decreases++;
+    }
+    
+    // The bottlenecks cost about as much as a rebuild, so they are only worth it against many cycle checks
+    bool filter = decreases > n;
+    if (!filter) cost += (double)decreases * n;
+    else {
+        computeBottlenecks();
+        for (unsigned c = 0; c < changes.size(); c++) {
+            int u = changes[c].u;
+            int v = changes[c].v;
+            if (u != v && !treeEdge[(long)u * n + v] && changes[c].weight < bottleneck[(long)u * n + v]) cost += n;
+        }
+    }
+
+    if (cost > rebuildFactor * n * n) {
+        for (unsigned c = 0; c < changes.size(); c++) 
+            if (changes[c].u != changes[c].v) setWeight(changes[c].u, changes[c].v, changes[c].weight);
+        rebuild();
+        return;
+    }
+
+    // One change at a time, so that the tree is minimum again before the next one. Membership 
+    // is that of the tree at the start, which the bottlenecks refer to.
+    vector<char> startedInTree(changes.size());
+    for (unsigned c = 0; c < changes.size(); c++) startedInTree[c] = treeEdge[(long)changes[c].u * n + changes[c].v];
+    
+    for (unsigned c = 0; c < changes.size(); c++) {
+        int u = changes[c].u;
+        int v = changes[c].v;
+        if (u == v) continue;
+        double old = w(u, v);
+        setWeight(u, v, changes[c].weight);
+        if (treeEdge[(long)u * n + v]) {
+            if (changes[c].weight > old) repairCut(u, v);
+        } 
+        else if (changes[c].weight < old && (!filter || startedInTree[c] || changes[c].weight < bottleneck[(long)u * n + v])) repairCycle(u, v);
+    }
+}
+
+// bottleneck[s][v]: heaviest upperWeight on the tree path from s to v, by a search from every s
+void DynamicMST::computeBottlenecks() {
+    bottleneck.resize((long)n * n);
+    for (int s = 0; s < n; s++) {
+        double *row = &bottleneck[(long)s * n];
+        std::fill(side.begin(), side.end(), 0);
+        side[s] = 1;
+        row[s]  = 0;
+        int head = 0;
+        int tail = 0;
+        queue[tail++] = s;
+        while (head < tail) {
+            int u = queue[head++];
+            for (unsigned k = 0; k < adjacency[u].size(); k++) {
+                int v = adjacency[u][k];
+                if (side[v]) continue;
+                side[v] = 1;
+                row[v]  = std::max(row[u], upperWeight[previous[v] == u ? v : u]);
+                queue[tail++] = v;
+            }
+        }
+    }
+}
+
+// Rooted at 0: previous[v] is the parent of v and subtree[v] the size of its subtree
+void DynamicMST::computeSubtreeSizes() {
+    std::fill(previous.begin(), previous.end(), -1);
+    previous[0] = 0;
+    int head = 0;
+    int tail = 0;
+    queue[tail++] = 0;
+    while (head < tail) {
+        int u = queue[head++];
+        for (unsigned k = 0; k < adjacency[u].size(); k++) {
+            int v = adjacency[u][k];
+            if (previous[v] != -1) continue;
+            previous[v] = u;
+            queue[tail++] = v;
+        }
+    }
+    for (int k = tail - 1; k >= 0; k--) subtree[queue[k]] = 1;
+    for (int k = tail - 1; k > 0; k--) subtree[previous[queue[k]]] += subtree[queue[k]];
+}
+
+void DynamicMST::update(const vector<double> &weights) {
+    if ((long)weights.size() < (long)n * n) 
+        Util::throwInvalidArgument("Error in DynamicMST: %d x %d weights expected, %d found.", n, n, (int)weights.size());
+    
+    vector<WeightChange> changes;
+    for (int u = 0; u < n; u++) {
+        for (int v = u + 1; v < n; v++) {
+            double weight = weights[(long)u * n + v];
+            if (weight == w(u, v)) continue;
+            WeightChange change;
+            change.u      = u;
+            change.v      = v;
+            change.weight = weight;
+            changes.push_back(change);
+        }
+    }
+    update(changes);
+}
+
+
+// (a, b) became lighter: it replaces the heaviest edge of the tree path from a to b, if lighter still
+void DynamicMST::repairCycle(int a, int b) {
+    cycleChecks++;
+    
+    std::fill(previous.begin(), previous.end(), -1);
+    previous[a] = a;
+    int head = 0;
+    int tail = 0;
+    queue[tail++] = a;
+    while (head < tail && previous[b] == -1) {
+        int u = queue[head++];
+        for (unsigned k = 0; k < adjacency[u].size(); k++) {
+            int v = adjacency[u][k];
+            if (previous[v] != -1) continue;
+            previous[v] = u;
+            queue[tail++] = v;
+        }
+    }
+
+    int heaviestU = -1;
+    int heaviestV = -1;
+    double heaviest = w(a, b);
+    for (int v = b; v != a; v = previous[v]) {
+        if (w(previous[v], v) > heaviest) {
+            heaviest  = w(previous[v], v);
+            heaviestU = previous[v];
+            heaviestV = v;
+        }
+    }
+    if (heaviestU == -1) return;
+
+    removeTreeEdge(heaviestU, heaviestV);
+    addTreeEdge(a, b);
+    swaps++;
+}
+
+// Tree edge (a, b) became heavier: it is replaced by the lightest edge across the cut it leaves, if lighter
+void DynamicMST::repairCut(int a, int b) {
+    cutChecks++;
+    removeTreeEdge(a, b);
+
+    std::fill(side.begin(), side.end(), 0);
+    side[a] = 1;
+    int head = 0;
+    int tail = 0;
+    queue[tail++] = a;
+    while (head < tail) {
+        int u = queue[head++];
+        for (unsigned k = 0; k < adjacency[u].size(); k++) {
+            int v = adjacency[u][k];
+            if (side[v]) continue;
+            side[v] = 1;
+            queue[tail++] = v;
+        }
+    }
+
+    // Scan from the smaller side
+    int flip = 0;
+    if (2 * tail > n) {
+        flip = 1;
+        tail = 0;
+        for (int u = 0; u < n; u++) if (!side[u]) queue[tail++] = u;
+    }
+
+    int bestU = a;
+    int bestV = b;
+    double best = w(a, b);
+    for (int k = 0; k < tail; k++) {
+        int u = queue[k];
+        const double *row = &weights[(long)u * n];
+        for (int v = 0; v < n; v++) {
+            if ((side[v] ^ flip) || row[v] >= best) continue;
+            best  = row[v];
+            bestU = u;
+            bestV = v;
+        }
+    }
+
+    addTreeEdge(bestU, bestV);
+    if (bestU != a || bestV != b) swaps++;
+}
+
+
+void DynamicMST::setWeight(int u, int v, double weight) {
+    weights[(long)u * n + v] = weight;
+    weights[(long)v * n + u] = weight;
+}
+
+void DynamicMST::addTreeEdge(int u, int v) {
+    treeEdge[(long)u * n + v] = 1;
+    treeEdge[(long)v * n + u] = 1;
+    adjacency[u].push_back(v);
+    adjacency[v].push_back(u);
+}
+
+void DynamicMST::removeTreeEdge(int u, int v) {
+    treeEdge[(long)u * n + v] = 0;
+    treeEdge[(long)v * n + u] = 0;
+    adjacency[u].erase(std::find(adjacency[u].begin(), adjacency[u].end(), v));
+    adjacency[v].erase(std::find(adjacency[v].begin(), adjacency[v].end(), u));
+}
+
+
+vector<MSTEdge> DynamicMST::getTree() const {
+    vector<MSTEdge> tree;
+    for (int u = 0; u < n; u++) {
+        for (unsigned k = 0; k < adjacency[u].size(); k++) {
+            int v = adjacency[u][k];
+            if (v < u) continue;
+            MSTEdge edge;
+            edge.u      = u;
+            edge.v      = v;
+            edge.weight = w(u, v);
+            tree.push_back(edge);
+        }
+    }
+    return tree;
+}
+
+double DynamicMST::getWeight() const {
+    return AlgoUtil::treeWeight(getTree());
+}
@@ -0,0 +1,95 @@
+/**
+ * DynamicMST.h
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef DYNAMICMST_H
+#define DYNAMICMST_H
+
+#include "Util.h"
+#include "AlgoUtil.h"
+
+// New weight of the edge (u, v)
+struct WeightChange {
+    int    u;
+    int    v;
+    double weight;
+};
+
+/**
+ * Minimum spanning tree of a complete graph whose weights change a little at a
+ * time, as the distances of consecutive rolling windows. A change can only 
+ * break optimality in two ways: a tree edge becoming heavier (checked on the 
+ * cut it defines) or a non-tree edge becoming lighter (checked on the cycle it 
+ * closes). Each is repaired by at most one swap; every other change is free, 
+ * as are non-tree edges that stay above the bottleneck of their tree path. 
+ * If the checks would cost more than rebuildFactor times a dense Prim, the tree 
+ * is rebuilt instead.
+ */
+class DynamicMST {
+
+    private:
+
+        int n;
+        int threads;
+        double rebuildFactor;
+
+        vector<double>       weights;   // n x n row-major
+        vector<char>         treeEdge;  // n x n, 1 for the edges of the tree
+        vector<vector<int> > adjacency; // of the tree
+
+        // Buffers of the tree searches
+        vector<int> previous;
+        vector<int> queue;
+        vector<int> side;
+        vector<int> subtree;
+
+        // Of the tree at the start of an update: the larger of the old and new weights of
+        // the edge from v to its parent, and the heaviest of those on the path between two vertices
+        vector<double> upperWeight;
+        vector<double> bottleneck;
+
+        int rebuilds;
+        int cycleChecks;
+        int cutChecks;
+        int swaps;
+
+        double w(int u, int v) const { return weights[(long)u * n + v]; }
+        void setWeight(int u, int v, double weight);
+        void addTreeEdge(int u, int v);
+        void removeTreeEdge(int u, int v);
+
+        void rebuild();
+        void computeSubtreeSizes();
+        void computeBottlenecks();
+        void repairCycle(int a, int b);
+        void repairCut(int a, int b);
+
+    public:
+
+        DynamicMST();
+        ~DynamicMST();
+
+        void setThreads(int threads)      { this->threads = threads; }
+        void setRebuildFactor(double f)   { rebuildFactor = f; }
+
+        // weights is the n x n row-major symmetric matrix
+        void initialise(int n, const vector<double> &weights);
+        void update(const vector<WeightChange> &changes);
+        // Same, with the changes being the entries that differ from the current weights
+        void update(const vector<double> &weights);
+
+        vector<MSTEdge> getTree() const;
+        double getWeight() const;
+        const vector<double> &getWeights() const { return weights; }
+
+        int getRebuilds()    const { return rebuilds;    }
+        int getCycleChecks() const { return cycleChecks; }
+        int getCutChecks()   const { return cutChecks;   }
+        int getSwaps()       const { return swaps;       }
+};
+
+#endif
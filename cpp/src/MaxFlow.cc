@@ -0,0 +1,154 @@
+/**
+ * MaxFlow.cc
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "MaxFlow.h"
+
+// Flow below this is treated as zero
+#define FLOW_EPS 1e-10
+
+MaxFlow::MaxFlow() {
+    n = 0;
+    s = 0;
+    t = 0;
+}
+
+MaxFlow::~MaxFlow() {
+}
+
+void MaxFlow::reset(int n) {
+    this->n = n;
+    head.assign(n, -1);
+    next.clear();
+    to.clear();
+    capacity.clear();
+    
+    if ((int)excess.size() < n) {
+        excess.resize(n);
+        height.resize(n);
+        current.resize(n);
+        active.resize(n);
+        reachesSink.resize(n);
+    }
+    heightCount.resize(2*n + 1);
+}
+
+int MaxFlow::addArc(int u, int v, double cap, double reverseCap) {
+    int e = (int)to.size();
+    
+    to.push_back(v);
+    capacity.push_back(cap);
+    next.push_back(head[u]);
+    head[u] = e;
+    
+    to.push_back(u);
+    capacity.push_back(reverseCap);
+    next.push_back(head[v]);
+    head[v] = e + 1;
+    
+    return e;
+}
+
+void MaxFlow::push(int e, int u) {
+    int v = to[e];
+    double delta = std::min(excess[u], residual[e]);
+    residual[e]   -= delta;
+    residual[e^1] += delta;
+    excess[u]     -= delta;
+    excess[v]     += delta;
+    if (!active[v] && v != s && v != t) {
+        active[v] = 1;
+        activeQueue.push_back(v);
+    }
+}
+
+void MaxFlow::relabel(int u) {
+    int oldHeight = height[u];
+    int minHeight = 2*n;
+    for (int e = head[u]; e != -1; e = next[e]) {
+        if (residual[e] > FLOW_EPS) minHeight = std::min(minHeight, height[to[e]] + 1);
+    }
+    heightCount[oldHeight]--;
+    height[u] = minHeight;
+    heightCount[minHeight]++;
+    current[u] = head[u];
+
+    // Gap: nothing left at oldHeight, the nodes above it can no longer reach t
+    if (heightCount[oldHeight] == 0 && oldHeight < n) {
+        for (int v = 0; v < n; v++) {
+            if (v != s && height[v] > oldHeight && height[v] < n) {
+                heightCount[height[v]]--;
+                height[v] = n + 1;
+                heightCount[height[v]]++;
+                current[v] = head[v];
+            }
+        }
+    }
+}
+
+void MaxFlow::discharge(int u) {
+    while (excess[u] > FLOW_EPS) {
+        int e = current[u];
+        if (e == -1) {
+            relabel(u);
+            if (height[u] >= 2*n) break;
+            continue;
+        }
+        if (residual[e] > FLOW_EPS && height[u] == height[to[e]] + 1) push(e, u);
+        else current[u] = next[e];
+    }
+}
+
+double MaxFlow::solve(int s, int t) {
+    this->s = s;
+    this->t = t;
+
+    residual = capacity;
+    std::fill(excess.begin(),  excess.begin()  + n, 0.0);
+    std::fill(height.begin(),  height.begin()  + n, 0);
+    std::fill(active.begin(),  active.begin()  + n, 0);
+    std::fill(heightCount.begin(), heightCount.end(), 0);
+    for (int v = 0; v < n; v++) current[v] = head[v];
+    activeQueue.clear();
+    
+    height[s] = n;
+    heightCount[0] = n - 1;
+    heightCount[n] = 1;
+    
+    for (int e = head[s]; e != -1; e = next[e]) {
+        excess[s] += residual[e];
+        push(e, s);
+    }
+
+    for (unsigned q = 0; q < activeQueue.size(); q++) {
+        int u = activeQueue[q];
+        active[u] = 0;
+        discharge(u);
+        if (excess[u] > FLOW_EPS && height[u] < 2*n && !active[u]) {
+            active[u] = 1;
+            activeQueue.push_back(u);
+        }
+    }
+
+    // Minimum cut: the nodes that still reach t through residual arcs are on the sink side
+    std::fill(reachesSink.begin(), reachesSink.begin() + n, 0);
+    reachesSink[t] = 1;
+    activeQueue.clear();
+    activeQueue.push_back(t);
+    for (unsigned q = 0; q < activeQueue.size(); q++) {
+        int v = activeQueue[q];
+        for (int e = head[v]; e != -1; e = next[e]) {
+            int w = to[e];
+            if (!reachesSink[w] && residual[e^1] > FLOW_EPS) {
+                reachesSink[w] = 1;
+                activeQueue.push_back(w);
+            }
+        }
+    }
+    
+    return excess[t];
+}
@@ -0,0 +1,70 @@
+/**
+ * MaxFlow.h
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef MAXFLOW_H
+#define MAXFLOW_H
+
+#include "Util.h"
+
+/**
+ * Push-relabel maximum flow (FIFO selection with the gap heuristic) on a 
+ * network with real capacities. Arcs are stored in pairs, arc e and its 
+ * residual e^1, so that a capacity can be given in both directions at once.
+ * The buffers grow as needed and are kept between calls.
+ */
+class MaxFlow {
+
+    private:
+
+        int n;
+        int s;
+        int t;
+
+        // Arc lists: arcs leaving node v are head[v], next[head[v]], ... until -1
+        vector<int>    head;
+        vector<int>    next;
+        vector<int>    to;
+        vector<double> capacity;
+        vector<double> residual;
+
+        vector<double> excess;
+        vector<int>    height;
+        vector<int>    heightCount;
+        vector<int>    current;
+        vector<char>   active;
+        vector<int>    activeQueue;
+        vector<char>   reachesSink;
+
+        void push(int e, int u);
+        void relabel(int u);
+        void discharge(int u);
+
+    public:
+
+        MaxFlow();
+        ~MaxFlow();
+
+        // Removes all arcs and sets the number of nodes
+        void reset(int n);
+        
+        // Adds u->v with capacity cap and v->u with capacity reverseCap, returns the index of u->v
+        int  addArc(int u, int v, double cap, double reverseCap = 0);
+        void setCapacity(int e, double cap) { capacity[e] = cap; }
+
+        // Returns the value of the maximum s-t flow
+        double solve(int s, int t);
+        
+        // After solve: true if v is on the source side of the minimum cut, 
+        // i.e. t cannot be reached from v in the residual network
+        bool isSourceSide(int v) const { return !reachesSink[v]; }
+
+        int getNumNodes() const { return n; }
+        int getNumArcs()  const { return (int)to.size(); }
+};
+
+#endif
@@ -9,6 +9,7 @@
 #include "Model.h"
 #include "CPLEX.h"
 #include "Options.h"
+#include <thread>
 
 /**
  * INITIAL METHODS
@@ -40,6 +41,9 @@ Model::Model() {
     callbackCalls     = 0;
     maxFlowCalls      = 0;
     cutsAdded         = 0;
+    separationsSkipped = 0;
+    cutsDuplicated     = 0;
+    cacheHits          = 0;
 
     bestSolutionTime  = 0;
     bestSolutionNodes = 0;
@@ -49,7 +53,19 @@ Model::Model() {
     firstNodeSolved   = false;
 
     totalNodes        = 0;
+
+    lpRows            = 0;
+    lpCols            = 0;
+    presolvedLpRows   = -1;
+    presolvedLpCols   = -1;
+
+    oracleBound        =  std::numeric_limits<double>::max();
+    objectiveCutoff    = -std::numeric_limits<double>::max();
+    oracleBoundReached = false;
     
+    numThreads = 1;
+    threadStatistics.resize(numThreads);
+
     counter = 0;
     debug = Options::getInstance()->getIntOption("debug");
 
@@ -71,22 +87,76 @@ void Model::setSolverParameters() {
     solver->setTimeLimit((double)Options::getInstance()->getIntOption("time_limit"));
     solver->setSolverCuts();
     solver->setLPMethod();
+
+    // CPLEX runs single-threaded when control callbacks are installed unless the 
+    // number of threads is set explicitly
+    numThreads = Options::getInstance()->getIntOption("threads");
+    if (numThreads == 0) numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    threadStatistics.assign(numThreads, CallbackStatistics());
+    solver->setThreads(numThreads);
+    solver->setParallelMode(Options::getInstance()->getIntOption("parallel_mode"));
     if (Options::getInstance()->getBoolOption("first_node_only")) solver->setNodeLimit(1);
+    if (hasObjectiveCutoff()) solver->setObjectiveCutoff(objectiveCutoff);
 
     if ( Options::getInstance()->getBoolOption("export_model")) solver->exportModel("bc_model.lp");
 
 }
 
 
+void Model::mergeThreadStatistics() {
+    callbackTime     = 0;
+    callbackDataTime = 0;
+    callbackCutsTime = 0;
+    maxFlowTime      = 0;
+    bfsTime          = 0;
+    maxFlowCalls     = 0;
+    maxFlowsSolved   = 0;
+    callbackCalls    = 0;
+    cutsAdded        = 0;
+    separationsSkipped = 0;
+    cutsDuplicated     = 0;
+    cacheHits          = 0;
+
+    for (unsigned t = 0; t < threadStatistics.size(); t++) {
+        callbackTime     += threadStatistics[t].callbackTime;
+        callbackDataTime += threadStatistics[t].callbackDataTime;
+        callbackCutsTime += threadStatistics[t].callbackCutsTime;
+        maxFlowTime      += threadStatistics[t].maxFlowTime;
+        bfsTime          += threadStatistics[t].bfsTime;
+        maxFlowCalls     += threadStatistics[t].maxFlowCalls;
+        maxFlowsSolved   += threadStatistics[t].maxFlowsSolved;
+        callbackCalls    += threadStatistics[t].callbackCalls;
+        cutsAdded        += threadStatistics[t].cutsAdded;
+        separationsSkipped += threadStatistics[t].separationsSkipped;
+        cutsDuplicated     += threadStatistics[t].cutsDuplicated;
+        cacheHits          += threadStatistics[t].cacheHits;
+    }
+}
+
+
 void Model::incumbentCallbackFunction() {
-    bestSolutionTime = Util::getTime() - solverStartTime;
+    std::lock_guard<std::mutex> lock(callbackMutex);
+    bestSolutionTime = Util::getWallTime() - solverStartTime;
 }
 
 
 
 void Model::nodeCallbackFunction(double bound) {
+    std::lock_guard<std::mutex> lock(callbackMutex);
     if (firstNodeSolved) return;
-    firstNodeTime = Util::getTime() - solverStartTime;
+    firstNodeTime = Util::getWallTime() - solverStartTime;
     firstNodeBound = bound;
     firstNodeSolved = true;
 }
+
+
+// Stops the solve as soon as the incumbent attains the analytic bound, there
+// is nothing left for the solver to prove.
+int Model::infoCallbackFunction(bool hasIncumbent, double incumbent, double bound) {
+    if (!hasIncumbent || !hasOracleBound()) return 0;
+    if (incumbent < oracleBound - Options::getInstance()->getDoubleOption("cuts_tolerance")) return 0;
+    
+    bool alreadyReached = oracleBoundReached.exchange(true);
+    if (debug > 1 && !alreadyReached) printf("Incumbent %.2f reached the oracle bound %.2f, stopping\n", incumbent, oracleBound);
+    return 1;
+}
@@ -10,6 +10,46 @@
 #define MODEL_H
 
 #include "Solver.h"
+#include <atomic>
+#include <mutex>
+
+/**
+ * Counters updated inside the separation callbacks. CPLEX may call them 
+ * concurrently, so every thread owns one and they are merged after the solve.
+ */
+struct CallbackStatistics {
+    double callbackTime;
+    double callbackDataTime;
+    double callbackCutsTime;
+    double maxFlowTime;
+    double bfsTime;
+
+    int maxFlowCalls;
+    int maxFlowsSolved;
+    int callbackCalls;
+    int cutsAdded;
+    int separationsSkipped;
+    int cutsDuplicated;
+    int cacheHits;
+
+    // Keeps the counters of two threads out of the same cache line
+    char padding[64];
+
+    CallbackStatistics() {
+        callbackTime     = 0;
+        callbackDataTime = 0;
+        callbackCutsTime = 0;
+        maxFlowTime      = 0;
+        bfsTime          = 0;
+        maxFlowCalls     = 0;
+        maxFlowsSolved   = 0;
+        callbackCalls    = 0;
+        cutsAdded        = 0;
+        separationsSkipped = 0;
+        cutsDuplicated     = 0;
+        cacheHits          = 0;
+    }
+};
 
 /**
  * Model, superclass of ssd, etc.
@@ -39,6 +79,9 @@ class Model {
        int maxFlowsSolved;
        int callbackCalls;
        int cutsAdded;
+       int separationsSkipped;
+       int cutsDuplicated;
+       int cacheHits;
  
        // Times
        double bestSolutionTime;
@@ -46,19 +89,39 @@ class Model {
        double firstNodeBound;
        bool firstNodeSolved;
         
+       // Problem size before and after presolve
+       int lpRows;
+       int lpCols;
+       int presolvedLpRows;
+       int presolvedLpCols;
+        
        // Nodes
        int totalNodes;
        // TODO do bestSolutionNodes
        // Look for CPX_CALLBACK_INFO_NODE_COUNT in 
        int bestSolutionNodes;
        
-       // Just so I can measure the bestSolutionTime by hand
+       // Just so I can measure the bestSolutionTime by hand (wall time: callbacks run on several threads)
        double solverStartTime;
 
+       // Bound oracle: analytic upper bound on the objective and the value
+       // a solution must beat to be of any use (best found elsewhere)
+       double oracleBound;
+       double objectiveCutoff;
+       std::atomic<bool> oracleBoundReached;
+
+       // One entry per solver thread, merged into the members above by mergeThreadStatistics
+       int numThreads;
+       vector<CallbackStatistics> threadStatistics;
+
+       // Guards the incumbent and node callbacks
+       std::mutex callbackMutex;
+
        int debug;
-       int counter;
+       std::atomic<int> counter;
 
        void setSolverParameters();
+       void mergeThreadStatistics();
        
        virtual void readSolution() { }
        virtual void assignWarmStart() { }
@@ -69,14 +132,24 @@ class Model {
         Model();
         virtual ~Model();
 
-        virtual vector<SolverCut> separationAlgorithm(vector<double> sol) {
+        // Must be reentrant: context.thread is the solver thread calling it, in [0, getNumThreads())
+        virtual vector<SolverCut> separationAlgorithm(const vector<double> &sol, const SeparationContext &context) {
             vector<SolverCut> sc;
             return sc;
         }
         virtual void incumbentCallbackFunction();
         virtual void nodeCallbackFunction(double bound);
+        // Returns 1 if the solve should be terminated
+        virtual int infoCallbackFunction(bool hasIncumbent, double incumbent, double bound);
+
+        void setOracleBound(double b)      { oracleBound     = b; }
+        void setObjectiveCutoff(double c)  { objectiveCutoff = c; }
+        bool hasOracleBound()              { return oracleBound < std::numeric_limits<double>::max(); }
+        bool hasObjectiveCutoff()          { return objectiveCutoff > -std::numeric_limits<double>::max(); }
+        bool wasOracleBoundReached()       { return oracleBoundReached; }
 
         Solver* getSolver()           {return solver;            }
+        int getNumThreads()           {return numThreads;        }
         double getTotalTime()         {return totalTime;         }
         double getSolvingTime()       {return solvingTime;       }
 
@@ -91,12 +164,19 @@ class Model {
         int getMaxFlowsSolved()       {return maxFlowsSolved;    }
         int getCallbackCalls()        {return callbackCalls;     }
         int getCutsAdded()            {return cutsAdded;         }
+        int getSeparationsSkipped()   {return separationsSkipped;}
+        int getCutsDuplicated()       {return cutsDuplicated;    }
+        int getCacheHits()            {return cacheHits;         }
  
         double getBestSolutionTime()  {return bestSolutionTime;  }
         double getFirstNodeTime()     {return firstNodeTime;     }
         double getFirstNodeBound()    {return firstNodeBound;    }
 
         int getTotalNodes()           {return totalNodes;        }
+        int getLPRows()               {return lpRows;            }
+        int getLPCols()               {return lpCols;            }
+        int getPresolvedLPRows()      {return presolvedLpRows;   }
+        int getPresolvedLPCols()      {return presolvedLpCols;   }
         int getBestSolutionNodes()    {return bestSolutionNodes; }
        
         int getCounter() {return counter++;}
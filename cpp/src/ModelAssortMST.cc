@@ -9,6 +9,7 @@
 #include "ModelAssortMST.h"
 #include "Options.h"
 #include "AlgoUtil.h"
+#include "Symmetry.h"
 
 ModelAssortMST::ModelAssortMST() : Model(){
     x = "x";
@@ -20,6 +21,16 @@ ModelAssortMST::ModelAssortMST() : Model(){
     D = 0;
     K = 0;
 
+    treeSize  = 0;
+    maxDegree = 0;
+
+    executionStartTime = 0;
+
+    symmetryClasses = 0;
+
+    gsecAnchors   = 3;
+    gsecUnionSize = 5;
+    cutsTolerance = 1e-7;
 }
 
 ModelAssortMST::~ModelAssortMST() {
@@ -30,15 +41,44 @@ void ModelAssortMST::execute(const Data &data) {
 
     float startTime = Util::getTime();
     prepareExecution(data);
-
-    solver->addLazyCallback(this);
-    //if (!Options::getInstance()->getBoolOption("integral_callbacks")) solver->addUserCutCallback(this);
     solve();
     totalTime = Util::getTime() - startTime;
     printSolutionVariables(4, 1);
 }  
 
 
+// Builds the model and starts solving it in another thread
+SolveHandle ModelAssortMST::executeAsync(const Data &data) {
+
+    executionStartTime = Util::getTime();
+    prepareExecution(data);
+    return solveAsync();
+}  
+
+
+SolveHandle ModelAssortMST::solveAsync() {
+    
+    // The cutoff may have been improved since the model was built
+    if (hasObjectiveCutoff()) solver->setObjectiveCutoff(objectiveCutoff);
+
+    // Only a handle polls the progress between info callbacks; the control callbacks are left 
+    // out of synchronous solves, where they could change the default search
+    solver->addIncumbentCallback(this);
+    solver->addNodeCallback(this);
+    solverStartTime = Util::getWallTime();
+    return solver->solveAsync();
+}
+
+
+void ModelAssortMST::finishExecution(const SolveHandle &handle) {
+    
+    handle.get();
+    finishSolve();
+    totalTime = Util::getTime() - executionStartTime;
+    printSolutionVariables(4, 1);
+}
+
+
 
 void ModelAssortMST::prepareExecution(const Data &data) {
 
@@ -50,18 +90,44 @@ void ModelAssortMST::prepareExecution(const Data &data) {
     assignWarmStart();
     setSolverParameters();    
  
-    /*
-    solver->addIncumbentCallback(this);
-    solver->addNodeCallback(this);
-    */
+    // One workspace per solver thread (numThreads is set by setSolverParameters)
+    workspaces.resize(numThreads);
+    for (int t = 0; t < numThreads; t++) workspaces[t].initialise(N);
+    schedulers.resize(numThreads);
+    for (int t = 0; t < numThreads; t++) schedulers[t].initialise(!Options::getInstance()->getBoolOption("integral_callbacks"));
+    separationCache.initialise(Options::getInstance()->getIntOption("separation_cache_size"));
+    // Read once here rather than in every callback
+    gsecAnchors   = Options::getInstance()->getIntOption("gsec_anchors");
+    gsecUnionSize = Options::getInstance()->getIntOption("gsec_union_size");
+    cutsTolerance = Options::getInstance()->getDoubleOption("cuts_tolerance");
+    cutPools.resize(numThreads);
+    for (int t = 0; t < numThreads; t++) cutPools[t].initialise(Options::getInstance()->getIntOption("max_cuts_per_round"), Options::getInstance()->getDoubleOption("max_cut_parallelism"));
+ 
+    solver->addLazyCallback(this);
+    if (!Options::getInstance()->getBoolOption("integral_callbacks")) solver->addUserCutCallback(this);
+
+    // Oracle bound, root node statistics and progress of the solve
+    solver->addInfoCallback(this);
 }
 
 
 void ModelAssortMST::solve() {
 
-    solverStartTime = Util::getTime();
+    solverStartTime = Util::getWallTime();
     solver->solve();
-    solvingTime = Util::getTime() - solverStartTime;
+    finishSolve();
+}
+
+
+void ModelAssortMST::finishSolve() {
+
+    solvingTime = Util::getWallTime() - solverStartTime;
+    mergeThreadStatistics();
+
+    lpRows          = solver->getNumRows();
+    lpCols          = solver->getNumCols();
+    presolvedLpRows = solver->getPresolvedNumRows();
+    presolvedLpCols = solver->getPresolvedNumCols();
 
     if (debug > 1) printf("\n---------\n");
     if (debug > 1) printf("Model solved in %.2fs, status = %d\n", solvingTime, solver->getStatus());
@@ -116,17 +182,24 @@ void ModelAssortMST::readSolution() {
     totalNodes = solver->getNodeCount();
     
     solution.resetSolution();
-    solution.setSolutionStatus(solver->solutionExists(), solver->isOptimal(),  solver->isInfeasible(), solver->isUnbounded());
+    // The solve was stopped because the incumbent attained the analytic bound, so it is optimal
+    bool optimal = solver->isOptimal() || (oracleBoundReached && solver->solutionExists());
+    solution.setSolutionStatus(solver->solutionExists(), optimal,  solver->isInfeasible(), solver->isUnbounded());
     if (!solver->solutionExists()) {
         if (debug) printf("Solution could not be read as it does not exist\n");     
     } else {
         solution.setValue    (solver->getObjValue() );
-        solution.setBestBound(solver->getBestBound());
+        solution.setBestBound(oracleBoundReached ? solver->getObjValue() : solver->getBestBound());
 
+        solution.setNumAssets(N);
         for (int i = 0; i < N-1; i++) {
             for (int j = i+1; j < N; j++) {
                 sol_x[i][j - i - 1] = solver->getColValue(x + lex(i) + "_" + lex(j));
                 if (sol_x[i][j -i - 1] < 0) sol_x[i][j - i - 1] = 0;
+                if (sol_x[i][j - i - 1] > 0.5) {
+                    solution.addEdge(i, j);
+                    solution.addEdge(j, i);
+                }
             }
         }
         for (int i = 0; i < N; i++) {
@@ -146,8 +219,11 @@ void ModelAssortMST::assignWarmStart() {
 void ModelAssortMST::createModel(const Data& data) {
 
     N = data.getNumAssets();
-    D = (int)(N+1)/2;
+    D = getDegreeLimit(N);
     K = Options::getInstance()->getIntOption("min_tree_size");
+
+    // Any degree up to maxDegree can be written with d <= maxDegree
+    if (maxDegree > 0 && maxDegree < D) D = maxDegree;
     
     int E = (N*N - N)/2;
 
@@ -156,14 +232,27 @@ void ModelAssortMST::createModel(const Data& data) {
     if (debug) printf("Number of variables: %d\n", numVariables);
     solver->changeObjectiveSense(true);
 
+    // The objective does not depend on the data (yet)
+    edgeObjective.resize(N-1);
+    for (int i = 0; i < N-1; i++) edgeObjective[i].assign(N - i - 1, 0);
+    vertexObjective.assign(N, 0);
+
     // Add binary x variables
-    for (int i = 0; i < N-1; i++)
-        for (int j = i+1; j < N; j++) 
-            solver->addBinaryVariable(0, x + lex(i) + "_" + lex(j));
+    xIndex.resize(N-1);
+    for (int i = 0; i < N-1; i++) {
+        xIndex[i].resize(N - i - 1);
+        for (int j = i+1; j < N; j++) {
+            solver->addBinaryVariable(edgeObjective[i][j - i - 1], x + lex(i) + "_" + lex(j));
+            xIndex[i][j - i - 1] = solver->getNumCols() - 1;
+        }
+    }
 
     // Add y variables
-    for (int i = 0; i < N; i++)
-        solver->addVariable(0, 1, 0, y + lex(i));
+    yIndex.resize(N);
+    for (int i = 0; i < N; i++) {
+        solver->addVariable(0, 1, vertexObjective[i], y + lex(i));
+        yIndex[i] = solver->getNumCols() - 1;
+    }
 
     // Add z variables
     for (int i = 0; i < N; i++)
@@ -189,7 +278,8 @@ void ModelAssortMST::createModel(const Data& data) {
         colNames[i] = y + lex(i);
         elements[i] = 1;
     }
-    solver->addRow(colNames, elements, K, 'G', "minTreeSize");
+    if (treeSize > 0) solver->addRow(colNames, elements, treeSize, 'E', "treeSize");
+    else              solver->addRow(colNames, elements, K,        'G', "minTreeSize");
 
 
     // (17) Sum x_ij = Sum y_i - 1;
@@ -243,6 +333,24 @@ void ModelAssortMST::createModel(const Data& data) {
     }
 
 
+    // Degree of every vertex is at most maxDegree
+    if (maxDegree > 0) {
+        colNames.resize(N-1);
+        elements.resize(N-1);
+        for (int i = 0; i < N; i++) {
+            int count = 0;
+            for (int j = 0; j < N; j++) {
+                if (i == j) continue;
+                int f1 = i < j ? i : j;
+                int f2 = i < j ? j : i;
+                colNames[count  ] = x + lex(f1) + "_" + lex(f2);
+                elements[count++] = 1;
+            }
+            solver->addRow(colNames, elements, maxDegree, 'L', "MaxDegree" + lex(i));
+        }
+    }
+
+
     // (27) x = dz
     colNames.resize(D + N - 1);
     elements.resize(D + N - 1);
@@ -282,43 +390,474 @@ void ModelAssortMST::createModel(const Data& data) {
             }
         }
     }
+
+    addSymmetryBreaking();
  
 }
 
 
+// Vertices that are twins with respect to the objective (and all constraints, which treat 
+// vertices alike) can be permuted freely. Inside every class of twins a <- b, consecutive 
+// in index order, we impose
+//   (1) y_a >= y_b
+//   (2) deg_a >= deg_b (degree as the sum of incident x)
+// Sorting the vertices of a class by decreasing degree satisfies both, since vertices 
+// outside the tree have degree zero and those in the tree (size K >= 3) at least one.
+void ModelAssortMST::addSymmetryBreaking() {
+    
+    int level = Options::getInstance()->getIntOption("symmetry");
+    if (level == 0) return;
+
+    vector<vector<int>> classes = Symmetry::twinClasses(edgeObjective, vertexObjective);
+    symmetryClasses = (int)classes.size();
+    if (debug) printf("Symmetry: %d classes of twin vertices\n", symmetryClasses);
+
+    vector<string> colNames;
+    vector<double> elements;
+    
+    for (unsigned c = 0; c < classes.size(); c++) {
+        for (unsigned v = 0; v + 1 < classes[c].size(); v++) {
+            int a = classes[c][v];
+            int b = classes[c][v+1];
+
+            colNames.resize(2);
+            elements.resize(2);
+            colNames[0] = y + lex(a);
+            elements[0] = 1;
+            colNames[1] = y + lex(b);
+            elements[1] = -1;
+            solver->addRow(colNames, elements, 0, 'G', "SymY" + lex(a) + "_" + lex(b));
+
+            if (level < 2) continue;
+
+            // x_ab appears on both sides and cancels out
+            colNames.resize(2*(N-2));
+            elements.resize(2*(N-2));
+            int count = 0;
+            for (int j = 0; j < N; j++) {
+                if (j == a || j == b) continue;
+                colNames[count  ] = x + lex(a < j ? a : j) + "_" + lex(a < j ? j : a);
+                elements[count++] = 1;
+                colNames[count  ] = x + lex(b < j ? b : j) + "_" + lex(b < j ? j : b);
+                elements[count++] = -1;
+            }
+            solver->addRow(colNames, elements, 0, 'G', "SymDeg" + lex(a) + "_" + lex(b));
+        }
+    }
+}
+
+
 //////////////////////////////
 //////////////////////////////
 //////////////////////////////
 //////////////////////////////
 // Cutting plane
-vector<SolverCut> ModelAssortMST::separationAlgorithm(vector<double> sol) {
+vector<SolverCut> ModelAssortMST::separationAlgorithm(const vector<double> &sol, const SeparationContext &context) {
 
     
-    float startTime = Util::getTime();
+    double startTime = Util::getThreadTime();
 
-    callbackCalls++;
-    int callbackControl = std::numeric_limits<int>::max();
+    // Only this thread's counters, workspace and scheduler are touched here
+    CallbackStatistics  &stats     = threadStatistics[context.thread];
+    SeparationWorkspace &ws        = workspaces[context.thread];
+    SeparationScheduler &scheduler = schedulers[context.thread];
+    stats.callbackCalls++;
 
     vector<SolverCut> cuts;
 
-    //if (callbackCalls != 3) return cuts;
+    SeparationPlan plan = scheduler.plan(context);
+    if (!plan.components && !plan.maxFlow) {
+        stats.separationsSkipped++;
+        stats.callbackTime += Util::getThreadTime() - startTime;
+        return cuts;
+    }
     
-    int integer = 1;
+    bool integer = true;
     for (unsigned i = 0; i < sol.size(); i++) {
         if (fabs(sol[i] - round(sol[i])) > TOLERANCE) {
-            integer = 0;
+            integer = false;
             break;
         }
     }
 
-    if (callbackCalls > callbackControl) printf("%04d Callback (%s)\n", callbackCalls, integer ? "integer   " : "fractional");
+    if (debug > 3) printf("%04d Callback (%s) depth %d\n", stats.callbackCalls, integer ? "integer   " : "fractional", context.depth);
+
+    // At integer points the cuts only depend on the support, which may have been separated before
+    vector<unsigned long long> &support = ws.getSupport();
+    unsigned long long supportKey = 0;
+    bool cacheable = integer && separationCache.isEnabled();
+    if (cacheable) {
+        // x_ij can only be one if y_i and y_j are, so only those pairs are read
+        std::fill(support.begin(), support.end(), 0);
+        vector<int> chosen;
+        for (int i = 0; i < N; i++) {
+            if (sol[yIndex[i]] > 0.5) {
+                support[i >> 6] |= 1ULL << (i & 63);
+                chosen.push_back(i);
+            }
+        }
+        for (unsigned a = 0; a + 1 < chosen.size(); a++) {
+            int i = chosen[a];
+            for (unsigned b = a+1; b < chosen.size(); b++) {
+                int j = chosen[b];
+                if (sol[xCol(i, j)] > 0.5) {
+                    int bit = N + i*(2*N - i - 1)/2 + (j - i - 1);
+                    support[bit >> 6] |= 1ULL << (bit & 63);
+                }
+            }
+        }
+        supportKey = SeparationCache::hash(support);
+    }
 
-    // First thing we do: read the x values from the solution and create a directed graph where for every edge ij there is
-    // an edge ji with weights x_{ij} equal to the solution we just read.
+    long work = 0;
+    if (cacheable && separationCache.find(support, supportKey, cuts)) {
+        stats.cacheHits++;
+    } else {
+        work = separatePoint(sol, context, plan, integer, cuts);
+        if (cacheable) separationCache.insert(support, supportKey, cuts);
+    }
+
+    // Every round of a user cut callback counts at its node, whichever family found the cuts
+    if (!context.candidate) {
+        double maxViolation = 0;
+        for (unsigned c = 0; c < cuts.size(); c++) maxViolation = std::max(maxViolation, cuts[c].violation(sol));
+        scheduler.record(context, (int)cuts.size(), maxViolation, work);
+    }
+
+    // Duplicates and weak cuts are filtered by the pool
+    if (cuts.size() > 0) {
+        int duplicates = 0;
+        cuts = cutPools[context.thread].select(cuts, sol, context.candidate, duplicates);
+        stats.cutsDuplicated += duplicates;
+    }
+
+    stats.cutsAdded += (int)cuts.size();
+    stats.callbackTime += Util::getThreadTime() - startTime;
+    
+    return cuts;
+}
+
+
+// Builds the support graph of sol and runs the separation families of the plan. Returns 
+// the work done, the size of the support graph once per traversal (each maximum flow is one)
+long ModelAssortMST::separatePoint(const vector<double> &sol, const SeparationContext &context, const SeparationPlan &plan, 
+                                   bool integer, vector<SolverCut> &cuts) {
+
+    CallbackStatistics  &stats     = threadStatistics[context.thread];
+    SeparationWorkspace &ws        = workspaces[context.thread];
+
+    // First thing we do: read the x values from the solution and create an undirected graph with 
+    // weights x_{ij} equal to the solution we just read.
     //
     // This graph will be reduced as it will contain only the necessary number of elements 
-    // (those for which at least one x_ij is different from zero), then we need to map the indices in the 
+    // (those for which y_i is different from zero), then we need to map the indices in the 
     // reduced graph to the indices in the old graph
+    ws.reset();
+    
+    //////////////////
+    // Reading y and x
+    for (int i = 0; i < N; i++) {
+        double y_temp = sol[yIndex[i]];
+        if (y_temp > TOLERANCE) ws.addVertex(i, y_temp);
+    }
+    int numVertices = ws.getNumVertices();
+    for (int i = 0; i < numVertices-1; i++) {
+        int ii = ws.getOldIndex(i);
+        for (int j = i+1; j < numVertices; j++) {
+            int jj = ws.getOldIndex(j);
+
+            double x_temp = sol[xCol(ii, jj)];
+            if (x_temp > TOLERANCE) ws.addEdge(i, j, x_temp);
+        }
+    }
+    //////////////////
+    
+    //////////////////
+    // Checking for disconnected components
+    double tempTime = Util::getThreadTime();
+    int numComponents = ws.findComponents();
+    stats.bfsTime += (Util::getThreadTime() - tempTime);
+    //////////////////
+    
+
+    //////////////////
+    // Adding cuts
+    if (numComponents > 1) separateComponents(sol, ws, stats, cuts);
+    
+    // A connected fractional point may still violate a GSEC inside a component
+    int flowsSolved = stats.maxFlowsSolved;
+    if (cuts.size() == 0 && !integer && plan.maxFlow) separateMaxFlow(sol, ws, stats, cuts, plan.maxCuts);
+    //////////////////
+    
+    return (long)(1 + stats.maxFlowsSolved - flowsSolved) * (numVertices + ws.getNumEdges());
+}
+
+
+// GSEC of the set S (original indices) anchored at k in S:
+//     sum_{i<j in S} x_ij <= sum_{i in S \ {k}} y_i
+// Since sum x = sum y - 1 it can also be written over the pairs not inside S,
+//     sum_{i<j not both in S} x_ij - sum_{i not in S} y_i - y_k >= -1
+// which defines the same face and has fewer nonzeros when S covers most of V.
+//
+// The cut is assembled in the arena of the workspace. Its violation at sol is 
+// summed on the way (over S in both forms), and if it is not above tolerance the 
+// cut is discarded and -1 returned; otherwise returns its index in the arena.
+int ModelAssortMST::buildGSEC(const vector<int> &set, int anchor, const vector<double> &sol, double tolerance, SeparationWorkspace &ws) {
+    
+    CutArena &arena = ws.getArena();
+    long s = (long)set.size();
+    long direct     = s*(s-1)/2 + s - 1;
+    long complement = (long)N*(N-1)/2 - s*(s-1)/2 + (N - s) + 1;
+    bool useDirect  = direct <= complement;
+
+    if (useDirect) arena.open('L', 0);
+    
+    double violation = 0;
+    for (unsigned i = 0; i + 1 < set.size(); i++) {
+        for (unsigned j = i+1; j < set.size(); j++) {
+            int col = xCol(set[i], set[j]);
+            violation += sol[col];
+            if (useDirect) arena.addCoef(col, 1);
+        }
+    }
+    for (unsigned i = 0; i < set.size(); i++) {
+        if (set[i] == anchor) continue;
+        violation -= sol[yIndex[set[i]]];
+        if (useDirect) arena.addCoef(yIndex[set[i]], -1);
+    }
+
+    if (violation <= tolerance) {
+        if (useDirect) arena.discard();
+        return -1;
+    }
+    if (useDirect) return arena.close();
+
+    vector<char> &inSet = ws.getMarks();
+    for (unsigned i = 0; i < set.size(); i++) inSet[set[i]] = 1;
+    arena.open('G', -1);
+    for (int i = 0; i < N-1; i++) {
+        for (int j = i+1; j < N; j++) {
+            if (!inSet[i] || !inSet[j]) arena.addCoef(xCol(i, j), 1);
+        }
+    }
+    for (int i = 0; i < N; i++) {
+        if (!inSet[i]) arena.addCoef(yIndex[i], -1);
+    }
+    arena.addCoef(yIndex[anchor], -1);
+    for (unsigned i = 0; i < set.size(); i++) inSet[set[i]] = 0;
+    return arena.close();
+}
+
+
+// Cuts from the components W of the support graph. The violation of the GSEC of W 
+// anchored at k is x(E(W)) - y(W) + y_k, so the anchors are taken by decreasing y 
+// and W is skipped if the best one is not violated. At integer points every vertex
+// is an anchor as good as any other, gsec_anchors of them are used. Violated 
+// components with at most gsec_union_size vertices are also cut together: the union 
+// is violated whenever its parts each contain a cycle.
+void ModelAssortMST::separateComponents(const vector<double> &sol, SeparationWorkspace &ws, 
+                                        CallbackStatistics &stats, vector<SolverCut> &cuts) {
+    
+    double tempTime = Util::getThreadTime();
+    int numComponents = ws.getNumComponents();
+
+    // x(E(W)) and y(W) of every component, read from the support graph
+    vector<double> xSum(numComponents, 0);
+    vector<double> ySum(numComponents, 0);
+    for (int e = 0; e < ws.getNumEdges(); e++) xSum[ws.getComponentOf(ws.getEdgeFrom(e))] += ws.getEdgeValue(e);
+    for (int i = 0; i < ws.getNumVertices(); i++) ySum[ws.getComponentOf(i)] += ws.getY(i);
+
+    CutArena &arena = ws.getArena();
+    arena.clear();
+    vector<int> set;
+    vector<int> unionSet;
+    int unionAnchor  = -1;
+    double unionMaxY = -1;
+    int unionParts   = 0;
+    vector<std::pair<int, double>> byY;
+    
+    for (int c = 0; c < numComponents; c++) {
+        
+        int size = ws.getComponentSize(c);
+        set.resize(size);
+        byY.resize(size);
+        for (int i = 0; i < size; i++) {
+            int ii  = ws.getComponentVertex(c, i);
+            set[i]  = ws.getOldIndex(ii);
+            byY[i]  = std::make_pair(set[i], ws.getY(ii));
+        }
+        std::sort(byY.begin(), byY.end(), Util::sortPairDesc<int, double>());
+
+        double base = xSum[c] - ySum[c];
+        if (base + byY[0].second <= TOLERANCE) continue;
+
+        for (int a = 0; a < gsecAnchors && a < size; a++) {
+            if (base + byY[a].second > TOLERANCE) buildGSEC(set, byY[a].first, sol, TOLERANCE, ws);
+        }
+
+        if (size <= gsecUnionSize) {
+            unionSet.insert(unionSet.end(), set.begin(), set.end());
+            if (byY[0].second > unionMaxY) {
+                unionMaxY   = byY[0].second;
+                unionAnchor = byY[0].first;
+            }
+            unionParts++;
+        }
+    }
+    if (unionParts > 1) buildGSEC(unionSet, unionAnchor, sol, TOLERANCE, ws);
+
+    vector<double> violations;
+    arena.evaluate(sol, violations);
+    for (int c = 0; c < arena.getNumCuts(); c++) {
+        if (violations[c] > TOLERANCE) cuts.push_back(arena.getCut(c));
+    }
+    stats.callbackCutsTime += Util::getThreadTime() - tempTime;
+}
+
+
+// Exact separation of the GSECs at a fractional point. For a root k the most violated 
+// set containing k maximises x(E(S)) - y(S \ {k}). Since 2x(E(S)) = sum_{i in S} d_i - x(delta(S)),
+// with d_i the x-degree of i, this is x(E) - C(S) where C(S) is the capacity of the cut
+// (S + s, rest + t) in the network
+//
+//     s -> i  capacity d_i / 2  (infinite for k)
+//     i -> t  capacity y_i      (none for k)
+//     i -- j  capacity x_ij / 2 in both directions
+//
+// so a violated GSEC rooted at k exists iff the minimum cut is below x(E). Roots are 
+// taken by decreasing y and then shrunk into t (infinite i -> t): any set containing 
+// an earlier root has already been checked with a root of larger y, so this stays exact.
+// Stops after maxCuts cuts if it is positive.
+void ModelAssortMST::separateMaxFlow(const vector<double> &sol, SeparationWorkspace &ws, 
+                                       CallbackStatistics &stats, vector<SolverCut> &cuts, int maxCuts) {
+
+    double tempTime = Util::getThreadTime();
+    stats.maxFlowCalls++;
+    
+    int n = ws.getNumVertices();
+    if (n < 2) return;
+    
+    MaxFlow  &flow  = ws.getMaxFlow();
+    CutArena &arena = ws.getArena();
+    arena.clear();
+    int s = n;
+    int t = n + 1;
+    flow.reset(n + 2);
+
+    vector<double> degree(n, 0);
+    double totalX = 0;
+    for (int e = 0; e < ws.getNumEdges(); e++) {
+        double x = ws.getEdgeValue(e);
+        degree[ws.getEdgeFrom(e)] += x;
+        degree[ws.getEdgeTo(e)]   += x;
+        totalX += x;
+        flow.addArc(ws.getEdgeFrom(e), ws.getEdgeTo(e), x/2, x/2);
+    }
+
+    double totalY = 0;
+    for (int i = 0; i < n; i++) totalY += ws.getY(i);
+    double infinity = totalX + totalY + 1;
+
+    vector<int> sourceArc(n);
+    vector<int> sinkArc(n);
+    vector<std::pair<int, double>> roots(n);
+    for (int i = 0; i < n; i++) {
+        sourceArc[i] = flow.addArc(s, i, degree[i]/2);
+        sinkArc[i]   = flow.addArc(i, t, ws.getY(i));
+        roots[i]     = std::make_pair(i, ws.getY(i));
+    }
+    std::sort(roots.begin(), roots.end(), Util::sortPairDesc<int, double>());
+
+    int numCuts = 0;
+    vector<int> set;
+    for (int r = 0; r < n-1; r++) {
+        if (maxCuts > 0 && numCuts >= maxCuts) break;
+        int k = roots[r].first;
+        
+        flow.setCapacity(sourceArc[k], infinity);
+        flow.setCapacity(sinkArc[k], 0);
+        double cutValue = flow.solve(s, t);
+        stats.maxFlowsSolved++;
+
+        if (totalX - cutValue > cutsTolerance) {
+            set.clear();
+            for (int i = 0; i < n; i++) {
+                if (flow.isSourceSide(i)) set.push_back(ws.getOldIndex(i));
+            }
+            if (buildGSEC(set, ws.getOldIndex(k), sol, cutsTolerance, ws) >= 0) numCuts++;
+        }
+
+        // Shrinks k into the sink
+        flow.setCapacity(sourceArc[k], degree[k]/2);
+        flow.setCapacity(sinkArc[k], infinity);
+    }
+    
+    vector<double> violations;
+    arena.evaluate(sol, violations);
+    for (int c = 0; c < arena.getNumCuts(); c++) {
+        if (violations[c] > cutsTolerance) cuts.push_back(arena.getCut(c));
+    }
+    
+    stats.maxFlowTime += Util::getThreadTime() - tempTime;
+}
+
+
+// Times separationAlgorithm on random integer points: a random subset of vertices split 
+// into several trees, each closed into a cycle by one extra edge. The separation that 
+// came before workspaces (columns looked up by name, vector-of-vectors graph) is timed 
+// on the same points. Wall time, calls take less than the tick of Util::getTime().
+void ModelAssortMST::benchmarkSeparation(const Data &data, int calls) {
+
+    prepareExecution(data);
+    
+    // The same points are separated over and over, the cache would hide the cost
+    separationCache.initialise(0);
+
+    int numCols = solver->getNumCols();
+    vector<vector<double>> points(std::max(1, std::min(calls, 100)));
+    vector<int> vertices(N);
+    Util::initialiseSeed(1);
+    for (unsigned p = 0; p < points.size(); p++) {
+        points[p].assign(numCols, 0);
+        
+        std::iota(vertices.begin(), vertices.end(), 0);
+        for (int i = N-1; i > 0; i--) std::swap(vertices[i], vertices[Util::randomNumber(i+1)]);
+        int size = K + Util::randomNumber(N - K + 1);
+        int components = 1 + Util::randomNumber(std::max(1, size/4));
+
+        for (int c = 0; c < components; c++) {
+            int begin = c * size / components;
+            int end   = (c + 1) * size / components;
+            for (int i = begin; i < end; i++) {
+                points[p][yIndex[vertices[i]]] = 1;
+                if (i > begin) points[p][xCol(vertices[i], vertices[begin + Util::randomNumber(i - begin)])] = 1;
+            }
+            if (end - begin > 2) points[p][xCol(vertices[begin], vertices[end-1])] = 1;
+        }
+    }
+
+    SeparationContext context;
+    context.candidate = true;
+
+    int numCuts = 0;
+    double startTime = Util::getWallTime();
+    for (int c = 0; c < calls; c++) numCuts += (int)separationAlgorithm(points[c % points.size()], context).size();
+    double elapsed = Util::getWallTime() - startTime;
+    printf("Separation %-22s %9.3f us per call (%d calls, %d cuts)\n", "(workspace):", 1e6 * elapsed / std::max(1, calls), calls, numCuts);
+
+    int legacyCuts = 0;
+    startTime = Util::getWallTime();
+    for (int c = 0; c < calls; c++) legacyCuts += (int)legacySeparation(points[c % points.size()]).size();
+    double legacyElapsed = Util::getWallTime() - startTime;
+    printf("Separation %-22s %9.3f us per call (%d calls, %d cuts)\n", "(before workspaces):", 1e6 * legacyElapsed / std::max(1, calls), calls, legacyCuts);
+    if (elapsed > 0) printf("Speedup:                  %8.2fx\n", legacyElapsed / elapsed);
+}
+
+
+vector<SolverCut> ModelAssortMST::legacySeparation(const vector<double> &sol) {
+
+    vector<SolverCut> cuts;
+
     vector<double>         y_sol;
     vector<vector<int>>    graph;
     vector<vector<double>> x_sol;
@@ -329,8 +868,6 @@ vector<SolverCut> ModelAssortMST::separationAlgorithm(vector<double> sol) {
     std::fill(oldIndicesToNew.begin(), oldIndicesToNew.end(), -1);
     int currentIndex = 0;
     
-    //////////////////
-    // Reading y and x
     for (int i = 0; i < N; i++) {
         double y_temp = sol[solver->getColIndex(y + lex(i))];
         if (y_temp > TOLERANCE) {
@@ -355,36 +892,11 @@ vector<SolverCut> ModelAssortMST::separationAlgorithm(vector<double> sol) {
             }
         }
     }
-    //////////////////
-    
-    //////////////////
-    // Checking for disconnected components
-    float tempTime = Util::getTime();
+
     vector<vector<int>> verticesInCut;
     int disconnectedComponents = AlgoUtil::disconnectedComponents(graph, x_sol, verticesInCut);
-    bfsTime += (Util::getTime() - tempTime);
-    //////////////////
-    
-    /*
-    printf("In solution:\n");
-    for (int i = 0; i < (int)graph.size(); i++) {
-        printf("Y %2d -> %2d, value = %.2f\n", i, newIndicesToOld[i], y_sol[i]);
-    }
-    for (int i = 0; i < (int)graph.size(); i++) {
-        printf("X %2d:", i);
-        for (int j = 0; j < (int)graph[i].size(); j++) {
-            //printf(" %d", graph[i][j]);
-            printf(" %d:%.1f", graph[i][j], x_sol[i][j]);
-        }
-        printf("\n");
-    }
-    */
-
 
-    //////////////////
-    // Adding cuts
     if (disconnectedComponents) {
-        tempTime = Util::getTime();
         for (int v = 0; v < (int)verticesInCut.size(); v++) {
             
             vector<int> W;
@@ -399,12 +911,6 @@ vector<SolverCut> ModelAssortMST::separationAlgorithm(vector<double> sol) {
                 }
             }
 
-            //printf("Add cut: [y=%d]", maxYIndex);
-            //for (int i = 0; i < (int)W.size(); i++) printf(" %d", W[i]);
-            //printf("\n");
-
-
-
             SolverCut cut;
             cut.setSense('L');
             cut.setRHS(0);
@@ -418,17 +924,8 @@ vector<SolverCut> ModelAssortMST::separationAlgorithm(vector<double> sol) {
             for (unsigned i = 0; i < W.size(); i++) {
                 if (W[i] != maxYIndex) cut.addCoef(solver->getColIndex(y + lex(W[i])), -1);
             }
-            //printf("Cut evaluation: %.2f\n", cut.evaluate(sol));
             if (cut.evaluate(sol) > TOLERANCE) cuts.push_back(cut);
         }                 
-        callbackCutsTime += Util::getTime() - tempTime;
     }
-    //////////////////
-    
-
-
-    callbackTime += Util::getTime() - startTime;
-    
-    //printf("\n");
     return cuts;
 }
@@ -12,6 +12,10 @@
 #include "Model.h"
 #include "Solution.h"
 #include "Data.h"
+#include "SeparationWorkspace.h"
+#include "SeparationScheduler.h"
+#include "CutPool.h"
+#include "SeparationCache.h"
 
 class ModelAssortMST : public Model {
 
@@ -28,14 +32,54 @@ class ModelAssortMST : public Model {
         int D;
         int K;
 
+        // If positive, the tree has exactly treeSize vertices and 
+        // no vertex has degree larger than maxDegree
+        int treeSize;
+        int maxDegree;
+
+        // Objective coefficients of x and y. Symmetry breaking is derived from them, 
+        // so that it remains valid if distance-dependent terms are added
+        vector<vector<double>> edgeObjective;
+        vector<double>         vertexObjective;
+        int symmetryClasses;
+
+        // Column indices of x (diagonal matrix) and y, so that callbacks do not look names up
+        vector<vector<int>> xIndex;
+        vector<int>         yIndex;
+        int xCol(int i, int j) const { return i < j ? xIndex[i][j - i - 1] : xIndex[j][i - j - 1]; }
+
+        // One per solver thread
+        vector<SeparationWorkspace> workspaces;
+        vector<SeparationScheduler> schedulers;
+        vector<CutPool>             cutPools;
+
+        // Separation options, read in prepareExecution
+        int    gsecAnchors;
+        int    gsecUnionSize;
+        double cutsTolerance;
+        
+        // Shared by all threads
+        SeparationCache separationCache;
+
         void assignWarmStart();
 
+        // Separation of the subtour elimination constraints
+        long separatePoint(const vector<double> &sol, const SeparationContext &context, const SeparationPlan &plan, bool integer, vector<SolverCut> &cuts);
+        int  buildGSEC(const vector<int> &set, int anchor, const vector<double> &sol, double tolerance, SeparationWorkspace &ws);
+        void separateComponents(const vector<double> &sol, SeparationWorkspace &ws, CallbackStatistics &stats, vector<SolverCut> &cuts);
+        void separateMaxFlow(const vector<double> &sol, SeparationWorkspace &ws, CallbackStatistics &stats, vector<SolverCut> &cuts, int maxCuts = 0);
+        // The component cuts as separated before workspaces and cached column indices, only the benchmark uses it
+        vector<SolverCut> legacySeparation(const vector<double> &sol);
+
         // Model creation
         virtual void createModel(const Data& data);
+        void addSymmetryBreaking();
 
         // Execution
         void prepareExecution(const Data& data);
         void solve();
+        void finishSolve();
+        double executionStartTime;
 
         // Solution values
         vector<vector<double > > sol_x;
@@ -58,14 +102,31 @@ class ModelAssortMST : public Model {
         virtual ~ModelAssortMST();
 
         void execute(const Data &data);
+
+        // Asynchronous execution: executeAsync returns once the model is built, while
+        // the solver runs in another thread. finishExecution waits for it and reads the solution.
+        SolveHandle executeAsync(const Data &data);
+        void prepare(const Data &data) { executionStartTime = Util::getTime(); prepareExecution(data); }
+        SolveHandle solveAsync();
+        void finishExecution(const SolveHandle &handle);
         
         Solution getSolution()  { return solution;  }
         void printSolution()    { solution.print(); }
 
         void setDebug(int d) { debug = d; }
+        void setTreeSize(int k)  { treeSize  = k; }
+        void setMaxDegree(int p) { maxDegree = p; }
+
+        // Largest degree the model can represent on N vertices; a larger maxDegree gives the same model
+        static int getDegreeLimit(int N) { return (N+1)/2; }
+
+        int getSymmetryClasses() { return symmetryClasses; }
 
         // Separation algorithm
-        virtual vector<SolverCut> separationAlgorithm(vector<double> sol);
+        virtual vector<SolverCut> separationAlgorithm(const vector<double> &sol, const SeparationContext &context);
+        
+        // Prints the average time per call of separationAlgorithm
+        void benchmarkSeparation(const Data &data, int calls);
 
 
 };    
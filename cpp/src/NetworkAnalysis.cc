@@ -0,0 +1,445 @@
+/**
+ * NetworkAnalysis.cc
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "NetworkAnalysis.h"
+#include "Data.h"
+#include "Options.h"
+#include "AssortativityTest.h"
+#include "Returns.h"
+#include "ReturnsStore.h"
+#include "PriceIngest.h"
+#include "DynamicMST.h"
+#include "Bootstrap.h"
+#include "TreeAnalytics.h"
+#include "RMTFilter.h"
+
+
+NetworkAnalysis::NetworkAnalysis() {
+    totalTime = 0;
+    threads   = 1;
+}
+
+NetworkAnalysis::~NetworkAnalysis() {
+}
+
+void NetworkAnalysis::execute() {
+    double startTime = Util::getWallTime();
+    threads = Options::getInstance()->getIntOption("threads");
+
+    string model = Options::getInstance()->getStringOption("model");
+    if (model.compare("mst_returns") == 0) {
+        executeMSTReturns();
+    } else if (model.compare("mst_rolling") == 0) {
+        executeRollingMST();
+    } else if (model.compare("bootstrap") == 0) {
+        executeBootstrap();
+    } else if (model.compare("ingest") == 0) {
+        executeIngest();
+    } else {
+        Data data;
+        data.readData();
+        data.print();
+
+        if      (model.compare("mst") == 0)                executeMST(data);
+        else if (model.compare("pmfg") == 0)               executePMFG(data);
+        else if (model.compare("assortativity_test") == 0) executeAssortativityTest(data);
+    }
+
+    totalTime = Util::getWallTime() - startTime;
+    if (Options::getInstance()->getIntOption("debug")) printf("Total time:                %7.3fs\n", totalTime);
+}
+
+
+void NetworkAnalysis::executeMST(const Data& data) {
+    int N = data.getNumAssets();
+    
+    vector<double> distance;
+    getDistanceMatrix(data, distance);
+    
+    double startTime = Util::getWallTime();
+    vector<MSTEdge> tree = AlgoUtil::minimumSpanningTree(N, distance, threads, Options::getInstance()->getIntOption("mst_boruvka_size"));
+    double mstTime = Util::getWallTime() - startTime;
+
+    if (Options::getInstance()->getIntOption("debug")) {
+        printf("\n");
+        printf("Minimum spanning tree:    %8d edges\n", (int)tree.size());
+        printf("Tree weight:              %8.4f\n", AlgoUtil::treeWeight(tree));
+        printf("MST time:                  %7.3fs (%s)\n", mstTime, N >= Options::getInstance()->getIntOption("mst_boruvka_size") && threads != 1 ? "boruvka" : "prim");
+        TreeAnalytics::print(TreeAnalytics::analyse(tree, true));
+        if (Options::getInstance()->getIntOption("debug") > 1) {
+            for (unsigned e = 0; e < tree.size(); e++) printf("%5d %5d %9.6f\n", tree[e].u + 1, tree[e].v + 1, tree[e].weight);
+        }
+    }
+    
+    writeEdges(tree, N);
+}
+
+
+void NetworkAnalysis::executePMFG(const Data& data) {
+    int N = data.getNumAssets();
+    
+    vector<double> distance;
+    getDistanceMatrix(data, distance);
+
+    string method = Options::getInstance()->getStringOption("pmfg_method");
+    double startTime = Util::getWallTime();
+    vector<MSTEdge> graph = method.compare("tmfg") == 0 ? AlgoUtil::tmfg(N, distance) : AlgoUtil::pmfg(N, distance, NULL, threads);
+    double pmfgTime = Util::getWallTime() - startTime;
+
+    if (Options::getInstance()->getIntOption("debug")) {
+        printf("\n");
+        printf("Filtered graph:           %8d edges (%s)\n", (int)graph.size(), method.c_str());
+        printf("Total weight:             %8.4f\n", AlgoUtil::treeWeight(graph));
+        printf("Filtering time:            %7.3fs\n", pmfgTime);
+        if (Options::getInstance()->getIntOption("debug") > 1) {
+            for (unsigned e = 0; e < graph.size(); e++) printf("%5d %5d %9.6f\n", graph[e].u + 1, graph[e].v + 1, graph[e].weight);
+        }
+    }
+    
+    writeEdges(graph, N);
+}
+
+
+// The input file holds returns (T x N). The distance matrix is only built for rmt_denoise,
+// otherwise the tree is grown from the returns
+void NetworkAnalysis::executeMSTReturns() {
+    Returns returns;
+    readReturns(returns);
+    int N = returns.getNumAssets();
+    
+    if (Options::getInstance()->getIntOption("debug")) {
+        printf("Test instance:\n\n");
+        printf("Num Assets:    %d\n", N);
+        printf("Num Periods:   %d\n", returns.getNumPeriods());
+    }
+
+    // Denoising needs the whole correlation matrix, so the tree is then taken from the matrix
+    bool denoise = Options::getInstance()->getBoolOption("rmt_denoise");
+    vector<MSTEdge> tree;
+    double startTime = Util::getWallTime();
+    if (denoise) {
+        vector<double> distance((long)N * N);
+        Util::parallelFor(N, threads, [&](int, int u) { returns.getDistanceRow(u, 0, N, NULL, &distance[(long)u * N]); });
+        denoiseDistances(N, returns.getNumPeriods(), distance);
+        tree = AlgoUtil::minimumSpanningTree(N, distance, threads, Options::getInstance()->getIntOption("mst_boruvka_size"));
+    }
+    else tree = AlgoUtil::primReturns(returns, threads);
+    double mstTime = Util::getWallTime() - startTime;
+
+    if (Options::getInstance()->getIntOption("debug")) {
+        printf("\n");
+        printf("Minimum spanning tree:    %8d edges\n", (int)tree.size());
+        printf("Tree weight:              %8.4f\n", AlgoUtil::treeWeight(tree));
+        printf("MST time:                  %7.3fs (%s, %s dot products, %d threads)\n", mstTime, denoise ? "denoised matrix" : "prim on returns", Returns::getKernelName(), Util::getNumThreads(threads));
+        TreeAnalytics::print(TreeAnalytics::analyse(tree, true));
+        if (Options::getInstance()->getIntOption("debug") > 1) {
+            for (unsigned e = 0; e < tree.size(); e++) printf("%5d %5d %9.6f\n", tree[e].u + 1, tree[e].v + 1, tree[e].weight);
+        }
+    }
+    
+    writeEdges(tree, N);
+}
+
+
+// Trees of the Mantegna distances of windows of the returns, moved forward window_step periods
+// at a time. Sums of the window are updated as periods enter and leave, and each tree is 
+// repaired from the previous one.
+void NetworkAnalysis::executeRollingMST() {
+    int T = 0;
+    int N = 0;
+    vector<double> returns;
+    Returns::readFile(Options::getInstance()->getInputFile(), T, N, returns);
+    
+    int W    = Options::getInstance()->getIntOption("window");
+    int step = Options::getInstance()->getIntOption("window_step");
+    if (W > T) Util::throwInvalidArgument("Error: Window of %d periods, but only %d periods in the input.", W, T);
+    int debug = Options::getInstance()->getIntOption("debug");
+
+    double startTime = Util::getWallTime();
+    
+    vector<double> sum  (N, 0);
+    vector<double> cross((long)N * N, 0);
+    auto addPeriod = [&](int t, double sign) {
+        const double *r = &returns[(long)t * N];
+        for (int i = 0; i < N; i++) {
+            sum[i] += sign * r[i];
+            double *row = &cross[(long)i * N];
+            double ri = sign * r[i];
+            for (int j = i; j < N; j++) row[j] += ri * r[j];
+        }
+    };
+
+    vector<double> distance((long)N * N, 0);
+    auto computeDistances = [&]() {
+        for (int i = 0; i < N; i++) {
+            for (int j = i + 1; j < N; j++) {
+                double covariance = W * cross[(long)i * N + j] - sum[i] * sum[j];
+                double varianceI  = W * cross[(long)i * N + i] - sum[i] * sum[i];
+                double varianceJ  = W * cross[(long)j * N + j] - sum[j] * sum[j];
+                double rho = varianceI > 0 && varianceJ > 0 ? covariance / sqrt(varianceI * varianceJ) : 0;
+                rho = std::max(-1.0, std::min(1.0, rho));
+                distance[(long)i * N + j] = distance[(long)j * N + i] = sqrt(2 * (1 - rho));
+            }
+        }
+    };
+
+    for (int t = 0; t < W; t++) addPeriod(t, 1);
+    computeDistances();
+    
+    DynamicMST mst;
+    mst.setThreads(threads);
+    mst.initialise(N, distance);
+
+    vector<int>    windowStart (1, 0);
+    vector<double> windowWeight(1, mst.getWeight());
+    for (int start = step; start + W <= T; start += step) {
+        for (int t = start - step; t < std::min(start, start - step + W); t++) addPeriod(t, -1);
+        for (int t = std::max(start, start - step + W); t < start + W; t++)   addPeriod(t,  1);
+        computeDistances();
+        mst.update(distance);
+        
+        windowStart .push_back(start);
+        windowWeight.push_back(mst.getWeight());
+        if (debug > 1) printf("Window %5d: tree weight %9.4f\n", start + 1, windowWeight.back());
+    }
+    double rollingTime = Util::getWallTime() - startTime;
+
+    if (debug) {
+        printf("Test instance:\n\n");
+        printf("Num Assets:    %d\n", N);
+        printf("Num Periods:   %d\n", T);
+        printf("\n");
+        printf("Windows:                  %8d (%d periods, step %d)\n", (int)windowStart.size(), W, step);
+        printf("Trees rebuilt:            %8d\n", mst.getRebuilds());
+        printf("Cycle / cut checks:       %8d / %d\n", mst.getCycleChecks(), mst.getCutChecks());
+        printf("Edge swaps:               %8d\n", mst.getSwaps());
+        printf("Rolling time:              %7.3fs\n", rollingTime);
+    }
+
+    string outputFile = Options::getInstance()->getStringOption("output");
+    if (outputFile.empty()) return;
+
+    FILE* file;
+    if (!Util::openFile(&file, outputFile.c_str(), "w")) 
+        Util::throwInvalidArgument("Error: Output file '%s' could not be opened.", outputFile.c_str());
+    for (unsigned k = 0; k < windowStart.size(); k++) fprintf(file, "%d %.8f\n", windowStart[k] + 1, windowWeight[k]);
+    if (!Util::closeFile(&file)) Util::throwInvalidArgument("Error: File %s could not be closed.", outputFile.c_str());
+}
+
+
+// Tree of the returns and the fraction of bootstrap replicates that contain each of its edges
+void NetworkAnalysis::executeBootstrap() {
+    Returns returns;
+    readReturns(returns);
+    int N = returns.getNumAssets();
+    int debug = Options::getInstance()->getIntOption("debug");
+
+    Bootstrap bootstrap;
+    bootstrap.setParameters(Options::getInstance()->getIntOption("bootstrap_replicates"),
+                            Options::getInstance()->getIntOption("block_length"),
+                            Options::getInstance()->getIntOption("seed"), threads);
+    bootstrap.run(returns);
+    const vector<MSTEdge> &tree = bootstrap.getTree();
+
+    if (debug) {
+        vector<double> assortativity = bootstrap.getAssortativity();
+        vector<double> randic        = bootstrap.getRandic();
+        std::sort(assortativity.begin(), assortativity.end());
+        std::sort(randic.begin(), randic.end());
+        int replicates = randic.size();
+        int low  = (int)(0.05 * (replicates - 1));
+        int high = (int)(0.95 * (replicates - 1));
+        
+        double meanPersistence = 0;
+        for (unsigned e = 0; e < tree.size(); e++) meanPersistence += bootstrap.getPersistence(tree[e].u, tree[e].v);
+        if (!tree.empty()) meanPersistence /= tree.size();
+
+        printf("Test instance:\n\n");
+        printf("Num Assets:    %d\n", N);
+        printf("Num Periods:   %d\n", returns.getNumPeriods());
+        printf("\n");
+        printf("Bootstrap replicates:     %8d (blocks of %d periods)\n", replicates, Options::getInstance()->getIntOption("block_length"));
+        printf("Assortativity:            %8.4f [%.4f, %.4f]\n", bootstrap.getTreeIndices().assortativity, assortativity[low], assortativity[high]);
+        printf("Randic index:             %8.1f [%.1f, %.1f]\n", bootstrap.getTreeIndices().randic, randic[low], randic[high]);
+        printf("Mean edge persistence:    %8.4f\n", meanPersistence);
+        printf("Bootstrap time:            %7.3fs (%d threads)\n", bootstrap.getRunTime(), Util::getNumThreads(threads));
+        if (debug > 1) {
+            for (unsigned e = 0; e < tree.size(); e++) printf("%5d %5d %9.6f %6.3f\n", tree[e].u + 1, tree[e].v + 1, tree[e].weight, bootstrap.getPersistence(tree[e].u, tree[e].v));
+        }
+    }
+
+    string outputFile = Options::getInstance()->getStringOption("output");
+    if (outputFile.empty()) return;
+
+    FILE* file;
+    if (!Util::openFile(&file, outputFile.c_str(), "w")) 
+        Util::throwInvalidArgument("Error: Output file '%s' could not be opened.", outputFile.c_str());
+    fprintf(file, "%d %d\n", N, (int)tree.size());
+    for (unsigned e = 0; e < tree.size(); e++) 
+        fprintf(file, "%d %d %.8f %.6f\n", tree[e].u + 1, tree[e].v + 1, tree[e].weight, bootstrap.getPersistence(tree[e].u, tree[e].v));
+    if (!Util::closeFile(&file)) Util::throwInvalidArgument("Error: File %s could not be closed.", outputFile.c_str());
+}
+
+
+// Prices of the input file (CSV or SQLite) after the last date of the store in output
+void NetworkAnalysis::executeIngest() {
+    PriceIngest ingest;
+    ingest.setParameters(Options::getInstance()->getBoolOption("log_returns"), Options::getInstance()->getStringOption("index"));
+    ingest.run(Options::getInstance()->getInputFile(), Options::getInstance()->getStringOption("output"));
+
+    if (Options::getInstance()->getIntOption("debug")) {
+        printf("Prices read:              %8d (%d assets)\n", ingest.getNumRecords(), ingest.getNumAssets());
+        printf("New dates:                %8d (%s returns, %s)\n", ingest.getNumNewDates(), Options::getInstance()->getBoolOption("log_returns") ? "log" : "simple", 
+               ingest.wasInPlace() ? "appended in place" : "store written");
+        printf("Read time:                 %7.3fs\n", ingest.getReadTime());
+        printf("Returns time:              %7.3fs\n", ingest.getReturnsTime());
+        printf("Write time:                %7.3fs\n", ingest.getWriteTime());
+    }
+}
+
+
+// Same output as testAssortativity.r: one line per iteration with the tree size and its indices
+void NetworkAnalysis::executeAssortativityTest(const Data& data) {
+    int N = data.getNumAssets();
+    
+    vector<double> distance;
+    getDistanceMatrix(data, distance);
+
+    AssortativityTest test;
+    test.setParameters(Options::getInstance()->getIntOption("random_tests"),
+                       Options::getInstance()->getIntOption("vertices_in_tree"),
+                       Options::getInstance()->getIntOption("min_vertices_in_tree"),
+                       Options::getInstance()->getIntOption("seed"), threads);
+    test.run(N, distance);
+
+    const vector<double> &assortativity = test.getAssortativity();
+    int numTests = assortativity.size();
+    
+    if (Options::getInstance()->getIntOption("debug")) {
+        double mean = 0;
+        int    defined = 0;
+        for (int j = 0; j < numTests; j++) {
+            if (assortativity[j] != assortativity[j]) continue;
+            mean += assortativity[j];
+            defined++;
+        }
+        printf("\n");
+        printf("Assortativity tests:      %8d\n", numTests);
+        if (defined > 0) printf("Mean assortativity:       %8.4f (%d trees)\n", mean / defined, defined);
+        printf("Test time:                 %7.3fs (%d threads)\n", test.getRunTime(), Util::getNumThreads(threads));
+    }
+
+    string outputFile = Options::getInstance()->getStringOption("output");
+    if (outputFile.empty()) return;
+
+    FILE* file;
+    if (!Util::openFile(&file, outputFile.c_str(), "w")) 
+        Util::throwInvalidArgument("Error: Output file '%s' could not be opened.", outputFile.c_str());
+    
+    fprintf(file, "numVertices assortativity randic squaredDiff absoluteDiff\n");
+    for (int j = 0; j < numTests; j++) 
+        fprintf(file, "%d %.8f %.8f %.8f %.8f\n", test.getNumVertices()[j], assortativity[j], test.getRandic()[j], test.getSquaredDiff()[j], test.getAbsoluteDiff()[j]);
+    
+    if (!Util::closeFile(&file)) Util::throwInvalidArgument("Error: File %s could not be closed.", outputFile.c_str());
+}
+
+
+// A store is windowed by date and universe and its illiquid assets are dropped; 
+// the window is read from the mapped file straight into the standardised columns
+void NetworkAnalysis::readReturns(Returns &returns) {
+    string inputFile = Options::getInstance()->getInputFile();
+    if (!ReturnsStore::isStore(inputFile)) {
+        returns.readData(inputFile);
+        return;
+    }
+
+    ReturnsStore store;
+    store.open(inputFile);
+
+    vector<char> universe;
+    string universeFile = Options::getInstance()->getStringOption("universe");
+    if (!universeFile.empty()) {
+        FILE* file;
+        if (!Util::openFile(&file, universeFile.c_str(), "r")) 
+            Util::throwInvalidArgument("Error: Universe file '%s' was not found or could not be opened.", universeFile.c_str());
+        universe.assign(store.getNumAssets(), 0);
+        char name[256];
+        while (fscanf(file, "%255s", name) == 1) {
+            int i = store.findAsset(name);
+            if (i >= 0) universe[i] = 1;
+        }
+        if (!Util::closeFile(&file)) Util::throwInvalidArgument("Error: File %s could not be closed.", universeFile.c_str());
+    }
+
+    ReturnsWindow window = store.getWindow(Options::getInstance()->getIntOption("date_begin"), 
+                                           Options::getInstance()->getIntOption("date_end"), universe.empty() ? NULL : &universe);
+    int candidates = window.getNumAssets();
+    ReturnsStore::filterLiquid(window, Options::getInstance()->getIntOption("max_zero_run"));
+    if (window.numPeriods < 2 || window.getNumAssets() < 1) 
+        Util::throwInvalidArgument("Error: The window of '%s' has %d periods and %d assets.", inputFile.c_str(), window.numPeriods, window.getNumAssets());
+    
+    returns.setColumns(window.numPeriods, window.getColumns());
+
+    if (Options::getInstance()->getIntOption("debug")) {
+        printf("Returns store:            %8d assets, %d dates (%d to %d)\n", store.getNumAssets(), store.getNumDates(), 
+               store.getNumDates() > 0 ? store.getDate(0) : 0, store.getNumDates() > 0 ? store.getDate(store.getNumDates() - 1) : 0);
+        printf("Window:                   %8d dates (%d to %d)\n", window.numPeriods, store.getDate(window.begin), store.getDate(window.begin + window.numPeriods - 1));
+        printf("Liquid assets:            %8d of %d (%s zero runs)\n", window.getNumAssets(), candidates, ReturnsStore::getKernelName());
+        printf("\n");
+    }
+}
+
+
+void NetworkAnalysis::getDistanceMatrix(const Data& data, vector<double> &distance) {
+    data.getDistanceMatrix(distance);
+    if (!Options::getInstance()->getBoolOption("rmt_denoise")) return;
+
+    int T = Options::getInstance()->getIntOption("rmt_periods");
+    if (T <= 0) Util::throwInvalidArgument("Error: rmt_denoise needs the number of periods of the correlations (rmt_periods).");
+    denoiseDistances(data.getNumAssets(), T, distance);
+}
+
+
+// Back to correlations, filtered in place, then to Mantegna distances again
+void NetworkAnalysis::denoiseDistances(int numAssets, int numPeriods, vector<double> &distance) {
+    int N = numAssets;
+    double startTime = Util::getWallTime();
+    for (long k = 0; k < (long)N * N; k++) distance[k] = 1 - distance[k] * distance[k] / 2;
+    for (int i = 0; i < N; i++) distance[(long)i * N + i] = 1;
+
+    RMTFilter filter;
+    filter.setParameters(numPeriods, threads);
+    filter.denoise(N, distance);
+    if (!filter.hasConverged()) printf("Warning: RMT denoising stopped after %d iterations before converging.\n", filter.getIterations());
+
+    for (long k = 0; k < (long)N * N; k++) distance[k] = sqrt(std::max(0.0, 2 * (1 - distance[k])));
+    
+    if (Options::getInstance()->getIntOption("debug")) {
+        printf("\n");
+        printf("Marchenko-Pastur edge:    %8.4f (%d periods)\n", filter.getEdge(), numPeriods);
+        printf("Eigenvalues above edge:   %8d\n", filter.getNumSignal());
+        if (filter.getNumSignal() > 0) printf("Largest eigenvalue:       %8.4f\n", filter.getEigenvalues()[0]);
+        printf("Denoising time:            %7.3fs (%d iterations)\n", Util::getWallTime() - startTime, filter.getIterations());
+    }
+}
+
+
+// One edge per line, vertices numbered from 1 as in the R package
+void NetworkAnalysis::writeEdges(const vector<MSTEdge> &edges, int numAssets) {
+    string outputFile = Options::getInstance()->getStringOption("output");
+    if (outputFile.empty()) return;
+
+    FILE* file;
+    if (!Util::openFile(&file, outputFile.c_str(), "w")) 
+        Util::throwInvalidArgument("Error: Output file '%s' could not be opened.", outputFile.c_str());
+    
+    fprintf(file, "%d %d\n", numAssets, (int)edges.size());
+    for (unsigned e = 0; e < edges.size(); e++) fprintf(file, "%d %d %.8f\n", edges[e].u + 1, edges[e].v + 1, edges[e].weight);
+    
+    if (!Util::closeFile(&file)) Util::throwInvalidArgument("Error: File %s could not be closed.", outputFile.c_str());
+}
@@ -0,0 +1,54 @@
+/**
+ * NetworkAnalysis.h
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef NETWORKANALYSIS_H
+#define NETWORKANALYSIS_H
+
+#include "Util.h"
+#include "AlgoUtil.h"
+
+class Data;
+class Returns;
+
+/**
+ * Network computations that do not need a solver (minimum spanning tree, 
+ * PMFG, assortativity test, ...),
+ * in C++ rather than in the R package
+ */
+class NetworkAnalysis {
+
+    private:
+
+        double totalTime;
+        int    threads;
+
+        void executeMST(const Data& data);
+        void executeMSTReturns();
+        void executeRollingMST();
+        void executeBootstrap();
+        void executeIngest();
+        void executeAssortativityTest(const Data& data);
+        void executePMFG(const Data& data);
+        void writeEdges(const vector<MSTEdge> &edges, int numAssets);
+
+        // From a text file of returns, or a window of a returns store
+        void readReturns(Returns &returns);
+
+        // Distance matrix of the input, denoised if rmt_denoise is set
+        void getDistanceMatrix(const Data& data, vector<double> &distance);
+        void denoiseDistances(int numAssets, int numPeriods, vector<double> &distance);
+
+    public:
+   
+        NetworkAnalysis();
+        ~NetworkAnalysis();
+
+        void execute();
+};    
+
+#endif 
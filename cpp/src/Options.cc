@@ -62,10 +62,25 @@ void Options::assignDefaultValues() {
 
     vector<string> modelValues;
     modelValues.push_back("assort_mst");
+    modelValues.push_back("mst");
+    modelValues.push_back("assortativity_test");
+    modelValues.push_back("mst_returns");
+    modelValues.push_back("mst_rolling");
+    modelValues.push_back("pmfg");
+    modelValues.push_back("bootstrap");
+    modelValues.push_back("ingest");
+
+    vector<string> pmfgValues;
+    pmfgValues.push_back("exact");
+    pmfgValues.push_back("tmfg");
 
     vector<string> solverValues;
     solverValues.push_back("cplex");
     
+    vector<string> callbackValues;
+    callbackValues.push_back("legacy");
+    callbackValues.push_back("generic");
+    
     vector<string> empty;
    
     double dmax = std::numeric_limits<double>::max();
@@ -75,27 +90,58 @@ void Options::assignDefaultValues() {
     options.push_back(new IntOption ("debug",        "Level of debug information [0-4, 0 means no debug]", 0, 0, 4, 0));
     options.push_back(new BoolOption("export_model", "If (1) exports model to lp file", 0, 0));
     options.push_back(new BoolOption("first_node_only", "Solve only first node", 1, 0));
+    options.push_back(new BoolOption("integral_callbacks", "If (1) subtour cuts are only separated at integer solutions, if (0) fractional solutions are also separated by max-flow", 1, 1));
+    options.push_back(new IntOption ("benchmark_separation", "If positive, times this many calls of the separation algorithm instead of solving", 1, 0, imax, 0));
 
     
     // General options
-    options.push_back(new StringOption("model",     "Choose which model to solve (default: assort_mst)", 1, "assort_mst", modelValues));
+    options.push_back(new StringOption("model",     "Choose which model to solve, or (mst) computes the minimum spanning tree only, or (assortativity_test) runs the Monte Carlo assortativity test, or (mst_returns) computes the minimum spanning tree from a file of returns, or (mst_rolling) the trees of rolling windows of the returns, or (pmfg) the planar maximally filtered graph, or (bootstrap) the stability of the tree of a file of returns, or (ingest) appends the returns of a CSV or SQLite file of prices to the returns store given by output (default: assort_mst)", 1, "assort_mst", modelValues));
     options.push_back(new StringOption("output",    "Output file where solution will be written", 0, "", empty));
    
     
     // Model parameters
     options.push_back(new IntOption   ("min_tree_size", "Minimum tree size", 1, 3, imax, 3));
+    options.push_back(new IntOption   ("symmetry",      "Symmetry breaking among twin vertices: (0) none, (1) order y, (2) order y and degrees [Default: 2]", 1, 2, 2, 0));
+    options.push_back(new BoolOption  ("bound_oracle",  "If (1) solves one model per (tree size, max degree) pair, skipping pairs whose analytic bound cannot beat the best [Default: 0]", 1, 0));
+    options.push_back(new IntOption   ("mst_boruvka_size", "Minimum spanning trees of at least this many assets use parallel Boruvka instead of Prim [Default: 4096]", 1, 4096, imax, 2));
+    options.push_back(new IntOption   ("random_tests",         "Iterations of the assortativity test [Default: 1]", 1, 1, imax, 1));
+    options.push_back(new IntOption   ("vertices_in_tree",     "Assets sampled per assortativity test, or (0) a uniform number of at least min_vertices_in_tree [Default: 0]", 1, 0, imax, 0));
+    options.push_back(new IntOption   ("min_vertices_in_tree", "Fewest assets sampled per assortativity test [Default: 5]", 1, 5, imax, 2));
+    options.push_back(new IntOption   ("seed",                 "Seed of the assortativity test and of the bootstrap [Default: 2016]", 1, 2016, imax, 0));
+    options.push_back(new StringOption("pmfg_method",          "Planar filtered graph: (exact) PMFG with planarity tests, or (tmfg) its greedy approximation [Default: exact]", 1, "exact", pmfgValues));
+    options.push_back(new IntOption   ("bootstrap_replicates", "Block bootstrap replicates of the returns [Default: 100]", 1, 100, imax, 1));
+    options.push_back(new IntOption   ("block_length",         "Periods per block of the bootstrap [Default: 20]", 1, 20, imax, 1));
+    options.push_back(new IntOption   ("window",               "Periods per window of the rolling trees [Default: 250]", 1, 250, imax, 2));
+    options.push_back(new IntOption   ("window_step",          "Periods between consecutive rolling windows [Default: 5]", 1, 5, imax, 1));
+    options.push_back(new IntOption   ("date_begin",           "First date (YYYYMMDD) taken from a returns store, 0 for the first one [Default: 0]", 1, 0, imax, 0));
+    options.push_back(new IntOption   ("date_end",             "Last date (YYYYMMDD) taken from a returns store, 0 for the last one [Default: 0]", 1, 0, imax, 0));
+    options.push_back(new IntOption   ("max_zero_run",         "Assets of a returns store with more zero returns in a row are left out [Default: 2]", 1, 2, imax, 0));
+    options.push_back(new StringOption("universe",             "File with the names of the assets of a returns store to consider, one per line (default: all)", 1, "", empty));
+    options.push_back(new BoolOption  ("log_returns",          "If (1) ingest computes log returns, if (0) simple returns [Default: 0]", 1, 0));
+    options.push_back(new StringOption("index",                "Index (indexId) of the prices read from a SQLite database by ingest (default: every row)", 1, "", empty));
+    options.push_back(new BoolOption  ("rmt_denoise",          "If (1) eigenvalues of the correlation matrix below the Marchenko-Pastur edge are clipped before the distances are computed [Default: 0]", 1, 0));
+    options.push_back(new IntOption   ("rmt_periods",          "Periods the correlations were estimated from, needed by rmt_denoise when the input is a correlation file [Default: 0]", 1, 0, imax, 0));
+    options.push_back(new BoolOption  ("overlap_solves", "If (1) the next (k, p) model is built while the current one is solving [Default: 1]", 1, 1));
 
 
 
     options.push_back(new DoubleOption("cuts_tolerance",      "Tolerance level when adding violated cuts [default: 1e-7]", 1, 1e-7, dmax, 0));
+    options.push_back(new IntOption   ("gsec_anchors",        "GSECs per violated component, anchored at the vertices of largest y [default: 3]", 1, 3, imax, 1));
+    options.push_back(new IntOption   ("gsec_union_size",     "Violated components up to this size are also cut together (0 to disable) [default: 5]", 1, 5, imax, 0));
+    options.push_back(new IntOption   ("separation_cache_size", "Integer points whose cuts are remembered (0 to disable) [default: 256]", 1, 256, imax, 0));
+    options.push_back(new IntOption   ("max_cuts_per_round",  "Most user cuts added per separation round, by efficacy (0 for no limit) [default: 10]", 1, 10, imax, 0));
+    options.push_back(new DoubleOption("max_cut_parallelism", "User cuts more parallel than this to a better one are dropped [default: 0.9]", 1, 0.9, 1, 0));
 
     // Solver options 
     options.push_back(new StringOption("solver",             "Choose which solver to use [Default: cplex)", 1, "cplex", solverValues));
     options.push_back(new IntOption   ("solver_debug_level", "Choose the solver debug level [Default: 2]", 1, 2, 5, 0));
     options.push_back(new IntOption   ("time_limit",         "Time limit for the solver (in seconds, if zero time limit is not set)", 1, 21600, imax, 0));
+    options.push_back(new StringOption("callback_api",       "Solver callbacks: (legacy) restrict presolve to linear reductions, (generic) keep full presolve [Default: legacy]", 1, "legacy", callbackValues));
     options.push_back(new BoolOption  ("presolve",           "Presolve is (0) disabled or (1) enabled [Default: 1]",            1, 1));
     options.push_back(new IntOption   ("mip_emphasis",       "MIP emphasis (0 to 4) [Default: 0]",                       1, 0, 4,  0));
     options.push_back(new IntOption   ("lp_method",          "Set LP method [Default: 0]",                               1, 0, 6,  0));
+    options.push_back(new IntOption   ("threads",            "Number of solver threads (0 uses every core) [Default: 0]", 1, 0, imax, 0));
+    options.push_back(new IntOption   ("parallel_mode",      "Parallel mode: (-1) opportunistic, (0) automatic, (1) deterministic [Default: 1]", 1, 1, 1, -1));
     options.push_back(new IntOption   ("probing_level",      "MIP probing lebel (-1 to 3) [Default: 1]",                 1, 0, 3, -1));
    
     // Solver cuts
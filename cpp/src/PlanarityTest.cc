@@ -0,0 +1,229 @@
+/**
+ * PlanarityTest.cc
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "PlanarityTest.h"
+
+bool PlanarityTest::isPlanar(int n, int m, const int *u, const int *v, int extraU, int extraV) {
+    int total = extraU != -1 ? m + 1 : m;
+    if (n >= 3 && total > 3*n - 6) return false;
+    this->n = n;
+    this->m = total;
+
+    offsets.assign(n + 1, 0);
+    for (int e = 0; e < m; e++) {
+        offsets[u[e] + 1]++;
+        offsets[v[e] + 1]++;
+    }
+    if (extraU != -1) {
+        offsets[extraU + 1]++;
+        offsets[extraV + 1]++;
+    }
+    for (int i = 0; i < n; i++) offsets[i+1] += offsets[i];
+    neighbour.resize(2*total);
+    edgeOf.resize(2*total);
+    outOffsets.assign(offsets.begin(), offsets.end());
+    for (int e = 0; e < total; e++) {
+        int a = e < m ? u[e] : extraU;
+        int b = e < m ? v[e] : extraV;
+        neighbour[outOffsets[a]] = b;
+        edgeOf   [outOffsets[a]++] = e;
+        neighbour[outOffsets[b]] = a;
+        edgeOf   [outOffsets[b]++] = e;
+    }
+    m = total;
+
+    height    .assign(n, -1);
+    parentEdge.assign(n, -1);
+    source .resize(m);
+    target .resize(m);
+    lowpt  .resize(m);
+    lowpt2 .resize(m);
+    nesting.resize(m);
+    oriented   .assign(m, 0);
+    ref        .assign(m, -1);
+    lowptEdge  .assign(m, -1);
+    stackBottom.assign(m, 0);
+
+    roots.clear();
+    for (int i = 0; i < n; i++) {
+        if (height[i] != -1) continue;
+        height[i] = 0;
+        roots.push_back(i);
+        orient(i);
+    }
+
+    // Outgoing edges sorted by nesting depth (at most 2n + 1) with a counting sort
+    bucket.assign(2*n + 3, 0);
+    for (int e = 0; e < m; e++) bucket[nesting[e] + 1]++;
+    for (int d = 0; d + 1 < (int)bucket.size(); d++) bucket[d+1] += bucket[d];
+    byDepth.resize(m);
+    for (int e = 0; e < m; e++) byDepth[bucket[nesting[e]]++] = e;
+
+    outOffsets.assign(n + 1, 0);
+    for (int e = 0; e < m; e++) outOffsets[source[e] + 1]++;
+    for (int i = 0; i < n; i++) outOffsets[i+1] += outOffsets[i];
+    outEdges.resize(m);
+    bucket.assign(outOffsets.begin(), outOffsets.end() - 1); // now the insertion cursor
+    for (int k = 0; k < m; k++) {
+        int e = byDepth[k];
+        outEdges[bucket[source[e]]++] = e;
+    }
+
+    stack.clear();
+    for (unsigned r = 0; r < roots.size(); r++) {
+        if (!test(roots[r])) return false;
+    }
+    return true;
+}
+
+
+// DFS orientation: tree edges point away from the root, back edges towards it. 
+// lowpt[e] is the lowest height reached by a return edge from e or below it, lowpt2 the second lowest
+void PlanarityTest::orient(int v) {
+    int e = parentEdge[v];
+    for (int k = offsets[v]; k < offsets[v+1]; k++) {
+        int f = edgeOf[k];
+        if (oriented[f]) continue;
+        int w = neighbour[k];
+        oriented[f] = 1;
+        source[f]   = v;
+        target[f]   = w;
+        lowpt [f]   = height[v];
+        lowpt2[f]   = height[v];
+        
+        if (height[w] == -1) {
+            parentEdge[w] = f;
+            height[w]     = height[v] + 1;
+            orient(w);
+        } else {
+            lowpt[f] = height[w];
+        }
+
+        // Chordal edges go after the others of the same lowpt
+        nesting[f] = 2 * lowpt[f];
+        if (lowpt2[f] < height[v]) nesting[f]++;
+
+        if (e != -1) {
+            if (lowpt[f] < lowpt[e]) {
+                lowpt2[e] = std::min(lowpt[e], lowpt2[f]);
+                lowpt[e]  = lowpt[f];
+            } 
+            else if (lowpt[f] > lowpt[e]) lowpt2[e] = std::min(lowpt2[e], lowpt[f]);
+            else                          lowpt2[e] = std::min(lowpt2[e], lowpt2[f]);
+        }
+    }
+}
+
+
+bool PlanarityTest::test(int v) {
+    int e = parentEdge[v];
+    for (int k = outOffsets[v]; k < outOffsets[v+1]; k++) {
+        int ei = outEdges[k];
+        int w  = target[ei];
+        stackBottom[ei] = stack.size();
+        
+        if (ei == parentEdge[w]) {
+            if (!test(w)) return false;
+        } else {
+            lowptEdge[ei] = ei;
+            ConflictPair pair;
+            pair.left.low   = -1;
+            pair.left.high  = -1;
+            pair.right.low  = ei;
+            pair.right.high = ei;
+            stack.push_back(pair);
+        }
+
+        // Integrate the return edges of ei
+        if (lowpt[ei] < height[v]) {
+            if (k == outOffsets[v]) lowptEdge[e] = lowptEdge[ei];
+            else if (!addConstraints(ei, e)) return false;
+        }
+    }
+    
+    if (e != -1) removeBackEdges(e);
+    return true;
+}
+
+
+bool PlanarityTest::addConstraints(int ei, int e) {
+    ConflictPair P;
+    P.left.low   = -1;
+    P.left.high  = -1;
+    P.right.low  = -1;
+    P.right.high = -1;
+
+    // Return edges of ei all go to the same side
+    do {
+        ConflictPair Q = stack.back();
+        stack.pop_back();
+        if (!Q.left.empty()) std::swap(Q.left, Q.right);
+        if (!Q.left.empty()) return false;
+        
+        if (lowpt[Q.right.low] > lowpt[e]) {
+            if (P.right.empty()) P.right.high = Q.right.high;
+            else                 ref[P.right.low] = Q.right.high;
+            P.right.low = Q.right.low;
+        } else {
+            ref[Q.right.low] = lowptEdge[e];
+        }
+    } while ((int)stack.size() != stackBottom[ei]);
+
+    // Conflicting return edges of the previous siblings go to the other side
+    while (!stack.empty() && (conflicting(stack.back().left, ei) || conflicting(stack.back().right, ei))) {
+        ConflictPair Q = stack.back();
+        stack.pop_back();
+        if (conflicting(Q.right, ei)) std::swap(Q.left, Q.right);
+        if (conflicting(Q.right, ei)) return false;
+        
+        if (P.right.low != -1) ref[P.right.low] = Q.right.high;
+        if (Q.right.low != -1) P.right.low = Q.right.low;
+
+        if (P.left.empty()) P.left.high = Q.left.high;
+        else                ref[P.left.low] = Q.left.high;
+        P.left.low = Q.left.low;
+    }
+
+    if (!P.left.empty() || !P.right.empty()) stack.push_back(P);
+    return true;
+}
+
+
+int PlanarityTest::lowest(const ConflictPair &pair) const {
+    if (pair.left.empty())  return lowpt[pair.right.low];
+    if (pair.right.empty()) return lowpt[pair.left.low];
+    return std::min(lowpt[pair.left.low], lowpt[pair.right.low]);
+}
+
+
+// Drops the return edges that end at the source of e, whose subtree is finished
+void PlanarityTest::removeBackEdges(int e) {
+    int u = source[e];
+    while (!stack.empty() && lowest(stack.back()) == height[u]) stack.pop_back();
+
+    if (!stack.empty()) {
+        ConflictPair &P = stack.back();
+        while (P.left.high != -1 && target[P.left.high] == u) P.left.high = ref[P.left.high];
+        if (P.left.high == -1 && P.left.low != -1) {
+            ref[P.left.low] = P.right.low;
+            P.left.low = -1;
+        }
+        while (P.right.high != -1 && target[P.right.high] == u) P.right.high = ref[P.right.high];
+        if (P.right.high == -1 && P.right.low != -1) {
+            ref[P.right.low] = P.left.low;
+            P.right.low = -1;
+        }
+    }
+
+    if (lowpt[e] < height[u] && !stack.empty()) {
+        int hl = stack.back().left.high;
+        int hr = stack.back().right.high;
+        if (hl != -1 && (hr == -1 || lowpt[hl] > lowpt[hr])) ref[e] = hl;
+        else                                                 ref[e] = hr;
+    }
+}
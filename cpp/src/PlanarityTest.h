@@ -0,0 +1,85 @@
+/**
+ * PlanarityTest.h
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef PLANARITYTEST_H
+#define PLANARITYTEST_H
+
+#include "Util.h"
+
+/**
+ * Left-right planarity test (de Fraysseix and Rosenstiehl, as described by
+ * Brandes, "The Left-Right Planarity Test"), in O(n + m). Only decides 
+ * planarity, no embedding is built. Buffers are kept between calls, so 
+ * testing many graphs of similar size does not allocate.
+ */
+class PlanarityTest {
+
+    private:
+
+        struct Interval {
+            int low;
+            int high;
+            bool empty() const { return low == -1 && high == -1; }
+        };
+
+        struct ConflictPair {
+            Interval left;
+            Interval right;
+        };
+
+        int n;
+        int m;
+
+        // Undirected graph in CSR form
+        vector<int> roots;
+        vector<int> offsets;
+        vector<int> neighbour;
+        vector<int> edgeOf;
+
+        // Per vertex
+        vector<int> height;
+        vector<int> parentEdge;
+        
+        // Per edge, after orientation (source to target)
+        vector<int>  source;
+        vector<int>  target;
+        vector<char> oriented;
+        vector<int>  lowpt;
+        vector<int>  lowpt2;
+        vector<int>  nesting;
+        vector<int>  ref;
+        vector<int>  lowptEdge;
+        vector<int>  stackBottom;
+
+        // Outgoing edges of each vertex by nesting depth
+        vector<int> outOffsets;
+        vector<int> outEdges;
+        vector<int> byDepth;
+        vector<int> bucket;
+
+        vector<ConflictPair> stack;
+
+        void orient(int v);
+        bool test(int v);
+        bool addConstraints(int ei, int e);
+        void removeBackEdges(int e);
+
+        bool conflicting(const Interval &interval, int b) const {
+            return !interval.empty() && lowpt[interval.high] > lowpt[b];
+        }
+        int lowest(const ConflictPair &pair) const;
+
+    public:
+
+        PlanarityTest() : n(0), m(0) {}
+
+        // Simple graph with edges (u[e], v[e]), e < m, and (extraU, extraV) if not -1
+        bool isPlanar(int n, int m, const int *u, const int *v, int extraU = -1, int extraV = -1);
+};
+
+#endif
@@ -0,0 +1,250 @@
+/**
+ * PriceIngest.cc
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "PriceIngest.h"
+#include "ReturnsStore.h"
+#include <cmath>
+#include <cstring>
+
+#ifdef HAVE_SQLITE
+#include <sqlite3.h>
+#endif
+
+
+PriceIngest::PriceIngest() {
+    logReturns  = false;
+    fromDate    = 0;
+    numRecords  = 0;
+    numNewDates = 0;
+    inPlace     = false;
+    readTime    = 0;
+    returnsTime = 0;
+    writeTime   = 0;
+}
+
+PriceIngest::~PriceIngest() {
+}
+
+void PriceIngest::run(const string &inputFile, const string &storeFile) {
+    if (storeFile.empty()) Util::throwInvalidArgument("Error: The returns store to write must be given (option output).");
+
+    // An existing store is only appended to; anything else under its name is left alone
+    bool exists = Util::fileExists(storeFile);
+    int lastDate = 0;
+    std::unordered_map<string, double> storedPrices;
+    if (exists) {
+        if (!ReturnsStore::isStore(storeFile)) Util::throwInvalidArgument("Error: File '%s' exists and is not a returns store.", storeFile.c_str());
+        ReturnsStore store;
+        store.open(storeFile);
+        if (store.getNumDates() > 0) lastDate = store.getDate(store.getNumDates() - 1);
+        for (int i = 0; i < store.getNumAssets(); i++) storedPrices[store.getName(i)] = store.getLastPrice(i);
+    }
+
+    // The prices of the last date of the store give the first new returns. They are read
+    // if the input has them, and otherwise taken from the store, as a daily dump only holds the new dates
+    double startTime = Util::getWallTime();
+    fromDate = lastDate;
+    recordDate.clear();
+    recordAsset.clear();
+    recordPrice.clear();
+    assets.clear();
+    assetIndex.clear();
+    if (isSQLite(inputFile)) readSQLite(inputFile);
+    else                     readCSV(inputFile);
+    numRecords = recordDate.size();
+    readTime = Util::getWallTime() - startTime;
+
+    startTime = Util::getWallTime();
+    vector<int> calendar(recordDate);
+    if (lastDate > 0) calendar.push_back(lastDate);
+    std::sort(calendar.begin(), calendar.end());
+    calendar.erase(std::unique(calendar.begin(), calendar.end()), calendar.end());
+
+    int C = calendar.size();
+    int A = assets.size();
+    numNewDates = std::max(0, C - 1);
+    if (numNewDates == 0 || A == 0) {
+        numNewDates = 0;
+        inPlace = true;
+        returnsTime = Util::getWallTime() - startTime;
+        return;
+    }
+
+    vector<double> prices((long)A * C, std::numeric_limits<double>::quiet_NaN());
+    for (int r = 0; r < numRecords; r++) {
+        int c = std::lower_bound(calendar.begin(), calendar.end(), recordDate[r]) - calendar.begin();
+        prices[(long)recordAsset[r] * C + c] = recordPrice[r];
+    }
+    if (lastDate > 0) {
+        for (int i = 0; i < A; i++) {
+            std::unordered_map<string, double>::iterator it = storedPrices.find(assets[i]);
+            if (prices[(long)i * C] != prices[(long)i * C] && it != storedPrices.end()) prices[(long)i * C] = it->second;
+        }
+    }
+    vector<double> returns;
+    computeReturns(C, A, prices, logReturns, returns);
+    returnsTime = Util::getWallTime() - startTime;
+
+    startTime = Util::getWallTime();
+    vector<int> newDates(calendar.begin() + 1, calendar.end());
+    vector<double> lastPrices(A);
+    for (int i = 0; i < A; i++) lastPrices[i] = prices[(long)i * C + C - 1];
+    if (exists) inPlace = ReturnsStore::append(storeFile, assets, newDates, returns, lastPrices);
+    else {
+        // About a year of trading days of room for appends
+        ReturnsStore::create(storeFile, assets, newDates, returns, numNewDates + 256, lastPrices);
+        inPlace = false;
+    }
+    writeTime = Util::getWallTime() - startTime;
+}
+
+
+// A NaN price (missing, or not positive) makes the returns on both sides NaN. The ratios are
+// one pass over each column with no branches, which the compiler vectorises.
+void PriceIngest::computeReturns(int numPrices, int numAssets, const vector<double> &prices, bool logReturns, vector<double> &returns) {
+    int D = numPrices - 1;
+    returns.resize((long)numAssets * D);
+    for (int i = 0; i < numAssets; i++) {
+        const double* p = &prices[(long)i * numPrices];
+        double* r = &returns[(long)i * D];
+        for (int t = 0; t < D; t++) r[t] = p[t + 1] / p[t];
+        if (logReturns) for (int t = 0; t < D; t++) r[t] = log(r[t]);
+        else            for (int t = 0; t < D; t++) r[t] = r[t] - 1;
+    }
+}
+
+bool PriceIngest::isSQLite(const string &file) {
+    FILE* in;
+    if (!Util::openFile(&in, file.c_str(), "rb")) return false;
+    char magic[16];
+    bool result = fread(magic, 1, sizeof(magic), in) == sizeof(magic) && memcmp(magic, "SQLite format 3", sizeof(magic)) == 0;
+    Util::closeFile(&in);
+    return result;
+}
+
+
+void PriceIngest::addRecord(int date, const string &asset, double price) {
+    if (date < fromDate) return;
+    std::unordered_map<string, int>::iterator it = assetIndex.find(asset);
+    int i;
+    if (it != assetIndex.end()) i = it->second;
+    else {
+        i = assets.size();
+        assets.push_back(asset);
+        assetIndex[asset] = i;
+    }
+    recordDate.push_back(date);
+    recordAsset.push_back(i);
+    recordPrice.push_back(price > 0 ? price : std::numeric_limits<double>::quiet_NaN());
+}
+
+// Fields split on commas, quotes removed; dashes and slashes of dates are skipped
+void PriceIngest::readCSV(const string &inputFile) {
+    FILE* file;
+    if (!Util::openFile(&file, inputFile.c_str(), "r"))
+        Util::throwInvalidArgument("Error: Input file '%s' was not found or could not be opened.", inputFile.c_str());
+
+    int dateColumn  = 0;
+    int assetColumn = 1;
+    int priceColumn = 2;
+
+    char line[4096];
+    vector<string> fields;
+    long lineNumber = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        lineNumber++;
+        fields.clear();
+        string field;
+        for (char* c = line; *c != 0 && *c != '\n' && *c != '\r'; c++) {
+            if (*c == ',') {
+                fields.push_back(field);
+                field.clear();
+            }
+            else if (*c != '"') field += *c;
+        }
+        fields.push_back(field);
+        if (fields.size() == 1 && fields[0].empty()) continue;
+
+        int maxColumn = std::max(dateColumn, std::max(assetColumn, priceColumn));
+        if ((int)fields.size() <= maxColumn) {
+            Util::closeFile(&file);
+            Util::throwInvalidArgument("Error: Line %ld of '%s' has %d fields.", lineNumber, inputFile.c_str(), (int)fields.size());
+        }
+
+        int date = 0;
+        bool numeric = !fields[dateColumn].empty();
+        for (unsigned k = 0; k < fields[dateColumn].size() && numeric; k++) {
+            char c = fields[dateColumn][k];
+            if (c >= '0' && c <= '9') date = date * 10 + (c - '0');
+            else numeric = c == '-' || c == '/';
+        }
+
+        if (!numeric && lineNumber == 1) {
+            dateColumn = assetColumn = priceColumn = -1;
+            for (unsigned k = 0; k < fields.size(); k++) {
+                if      (fields[k].compare("date") == 0)                                         dateColumn  = k;
+                else if (fields[k].compare("companyId") == 0 || fields[k].compare("asset") == 0) assetColumn = k;
+                else if (fields[k].compare("close") == 0 || fields[k].compare("price") == 0)     priceColumn = k;
+            }
+            if (dateColumn < 0 || assetColumn < 0 || priceColumn < 0) {
+                Util::closeFile(&file);
+                Util::throwInvalidArgument("Error: The header of '%s' must name the columns date, companyId and close.", inputFile.c_str());
+            }
+            continue;
+        }
+
+        // An empty price is missing
+        char* end = NULL;
+        double price = fields[priceColumn].empty() ? -1 : strtod(fields[priceColumn].c_str(), &end);
+        if (!numeric || (end != NULL && (end == fields[priceColumn].c_str() || *end != 0))) {
+            Util::closeFile(&file);
+            Util::throwInvalidArgument("Error: Line %ld of '%s' is invalid.", lineNumber, inputFile.c_str());
+        }
+        addRecord(date, fields[assetColumn], price);
+    }
+    if (!Util::closeFile(&file)) Util::throwInvalidArgument("Error: File %s could not be closed.", inputFile.c_str());
+}
+
+// The whole range in one prepared statement, as in the datesAdjustedPrices table read by the R package
+void PriceIngest::readSQLite(const string &inputFile) {
+#ifdef HAVE_SQLITE
+    sqlite3* db = NULL;
+    if (sqlite3_open_v2(inputFile.c_str(), &db, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK) {
+        sqlite3_close(db);
+        Util::throwInvalidArgument("Error: Database '%s' could not be opened.", inputFile.c_str());
+    }
+
+    const char* query = "select date, companyId, close from datesAdjustedPrices where date >= ?1 and (?2 = '' or indexId = ?2)";
+    sqlite3_stmt* statement = NULL;
+    if (sqlite3_prepare_v2(db, query, -1, &statement, NULL) != SQLITE_OK) {
+        string message = sqlite3_errmsg(db);
+        sqlite3_close(db);
+        Util::throwInvalidArgument("Error: Query on '%s' failed: %s", inputFile.c_str(), message.c_str());
+    }
+    sqlite3_bind_int (statement, 1, fromDate);
+    sqlite3_bind_text(statement, 2, index.c_str(), -1, SQLITE_TRANSIENT);
+
+    int status;
+    string asset;
+    while ((status = sqlite3_step(statement)) == SQLITE_ROW) {
+        const unsigned char* text = sqlite3_column_text(statement, 1);
+        asset.assign(text != NULL ? (const char*)text : "");
+        double price = sqlite3_column_type(statement, 2) == SQLITE_NULL ? -1 : sqlite3_column_double(statement, 2);
+        addRecord(sqlite3_column_int(statement, 0), asset, price);
+    }
+    sqlite3_finalize(statement);
+    if (status != SQLITE_DONE) {
+        string message = sqlite3_errmsg(db);
+        sqlite3_close(db);
+        Util::throwInvalidArgument("Error: Reading '%s' failed: %s", inputFile.c_str(), message.c_str());
+    }
+    sqlite3_close(db);
+#else
+    Util::throwInvalidArgument("Error: '%s' is a SQLite database, but SQLite support was not compiled in; export the prices to CSV.", inputFile.c_str());
+#endif
+}
@@ -0,0 +1,79 @@
+/**
+ * PriceIngest.h
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef PRICEINGEST_H
+#define PRICEINGEST_H
+
+#include "Util.h"
+#include <unordered_map>
+
+/**
+ * Loads adjusted close prices from a dump of the database (CSV, or the SQLite
+ * file itself when built with HAVE_SQLITE) and writes their returns to a
+ * ReturnsStore. Only the dates after the last one of an existing store are
+ * read, with one prepared statement rather than a query per company, and
+ * appended, so a daily refresh reads and writes a few days. The first new
+ * returns start from the prices the store keeps for its last date, so the
+ * input need not repeat that date.
+ *
+ * CSV: date (YYYYMMDD or YYYY-MM-DD), company id and price per line. A header
+ * naming the columns date, companyId and close may give another order.
+ * Prices that are missing or not positive (-1 in the database) give NaN
+ * returns.
+ */
+class PriceIngest {
+
+    private:
+
+        bool   logReturns;
+        string index;
+
+        // Prices read, dates from fromDate on
+        int fromDate;
+        vector<int>    recordDate;
+        vector<int>    recordAsset;
+        vector<double> recordPrice;
+        vector<string> assets;
+        std::unordered_map<string, int> assetIndex;
+
+        int    numRecords;
+        int    numNewDates;
+        bool   inPlace;
+        double readTime;
+        double returnsTime;
+        double writeTime;
+
+        void addRecord(int date, const string &asset, double price);
+        void readCSV(const string &inputFile);
+        void readSQLite(const string &inputFile);
+
+    public:
+
+        PriceIngest();
+        ~PriceIngest();
+
+        // index filters the rows of the SQLite table by indexId (empty for every row)
+        void setParameters(bool logReturns, const string &index) { this->logReturns = logReturns; this->index = index; }
+
+        void run(const string &inputFile, const string &storeFile);
+
+        // returns[t] from prices[t] and prices[t+1], numPrices x numAssets column-major
+        // in, (numPrices - 1) x numAssets out
+        static void computeReturns(int numPrices, int numAssets, const vector<double> &prices, bool logReturns, vector<double> &returns);
+        static bool isSQLite(const string &file);
+
+        int    getNumRecords()  const { return numRecords;  }
+        int    getNumNewDates() const { return numNewDates; }
+        int    getNumAssets()   const { return assets.size(); }
+        bool   wasInPlace()     const { return inPlace; }
+        double getReadTime()    const { return readTime; }
+        double getReturnsTime() const { return returnsTime; }
+        double getWriteTime()   const { return writeTime; }
+};
+
+#endif
@@ -0,0 +1,255 @@
+/**
+ * RMTFilter.cc
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "RMTFilter.h"
+#include "CounterRNG.h"
+#include <cmath>
+
+RMTFilter::RMTFilter() {
+    numPeriods      = 0;
+    threads         = 1;
+    maxIterations   = 500;
+    tolerance       = 1e-8;
+    signalTolerance = 1e-6;
+    edge            = 0;
+    iterations      = 0;
+    converged       = true;
+}
+
+RMTFilter::~RMTFilter() {
+}
+
+
+// C' = sum_k (lambda_k - noise) v_k v_k' + noise I over the eigenpairs above the edge, 
+// noise = (trace - sum_k lambda_k) / (n - k), then C'_ij / sqrt(C'_ii C'_jj)
+void RMTFilter::denoise(int n, vector<double> &correlation) {
+    if (numPeriods <= 0) Util::throwInvalidArgument("Error in RMTFilter: the number of periods must be positive.");
+    if ((long)correlation.size() < (long)n * n) 
+        Util::throwInvalidArgument("Error in RMTFilter: %d x %d matrix expected, %d found.", n, n, (int)correlation.size());
+    
+    edge = pow(1 + sqrt((double)n / numPeriods), 2);
+    eigenvalues.clear();
+    iterations = 0;
+    converged  = true;
+    if (n <= 2) return;
+
+    double trace = 0;
+    for (int i = 0; i < n; i++) trace += correlation[(long)i * n + i];
+
+    // The block keeps a margin of unconverged vectors below the last eigenvalue above the edge
+    const int margin = 4;
+    int b = std::min(n, 16);
+    
+    vector<double> Q((long)n * b);
+    CounterRNG rng(2016, n);
+    for (long k = 0; k < (long)n * b; k++) Q[k] = rng.uniform() - 0.5;
+    orthonormalise(n, b, Q);
+
+    vector<double> W, H, theta, U, ritzQ, ritzW;
+    double boundary = 0;
+    int signal = 0;
+    converged = false;
+    while (iterations < maxIterations) {
+        iterations++;
+        multiply(n, b, correlation, Q, W);
+
+        // Rayleigh-Ritz: H = Q' C Q, then the Ritz vectors Q U and their images W U
+        H.assign((long)b * b, 0);
+        for (int i = 0; i < n; i++) {
+            const double *q = &Q[(long)i * b];
+            const double *w = &W[(long)i * b];
+            for (int r = 0; r < b; r++) for (int c = 0; c < b; c++) H[r * b + c] += q[r] * w[c];
+        }
+        for (int r = 0; r < b; r++) for (int c = r + 1; c < b; c++) H[r * b + c] = H[c * b + r] = (H[r * b + c] + H[c * b + r]) / 2;
+        jacobi(b, H, theta, U);
+
+        ritzQ.assign((long)n * b, 0);
+        ritzW.assign((long)n * b, 0);
+        for (int i = 0; i < n; i++) {
+            const double *q = &Q[(long)i * b];
+            const double *w = &W[(long)i * b];
+            double *rq = &ritzQ[(long)i * b];
+            double *rw = &ritzW[(long)i * b];
+            for (int r = 0; r < b; r++) {
+                const double *u = &U[(long)r * b];
+                for (int c = 0; c < b; c++) {
+                    rq[c] += q[r] * u[c];
+                    rw[c] += w[r] * u[c];
+                }
+            }
+        }
+
+        // Residuals |C v - theta v|: an eigenvalue lies within residual of each Ritz value. A pair 
+        // is signal once that interval is clear of the edge. The first pair that is not (below 
+        // the edge, or too close to it to tell) ends the signal, and is noise once settled.
+        signal = 0;
+        converged = true;
+        for (int c = 0; c < b; c++) {
+            double residual = 0;
+            for (int i = 0; i < n; i++) {
+                double d = ritzW[(long)i * b + c] - theta[c] * ritzQ[(long)i * b + c];
+                residual += d * d;
+            }
+            residual = sqrt(residual);
+            if (theta[c] - residual > edge) {
+                signal++;
+                if (residual > signalTolerance * theta[0]) converged = false;
+                continue;
+            }
+            if (residual > tolerance * theta[0] && fabs(theta[c] - boundary) >= 1e-3 * edge) converged = false;
+            boundary = theta[c];
+            break;
+        }
+        
+        // Too few vectors past the signal: grow the block with random vectors and start again, 
+        // unless this was the last iteration, whose Ritz pairs are the result
+        if (signal + margin > b && b < n && iterations < maxIterations) {
+            int grown = std::min(n, 2 * b);
+            vector<double> larger((long)n * grown);
+            for (int i = 0; i < n; i++) {
+                for (int c = 0; c < grown; c++) larger[(long)i * grown + c] = c < b ? ritzW[(long)i * b + c] : rng.uniform() - 0.5;
+            }
+            b = grown;
+            Q.swap(larger);
+            orthonormalise(n, b, Q);
+            boundary = 0;
+            converged = false;
+            continue;
+        }
+        if (converged) break;
+
+        Q.swap(ritzW);
+        orthonormalise(n, b, Q);
+    }
+    if (signal == b) signal = b - 1;
+
+    eigenvalues.assign(theta.begin(), theta.begin() + signal);
+    double noise = trace;
+    for (int k = 0; k < signal; k++) noise -= eigenvalues[k];
+    noise /= n - signal;
+
+    // ritzQ holds the Ritz vectors of the last iteration
+    Util::parallelFor((n + 63) / 64, threads, [&](int, int block) {
+        int begin = block * 64;
+        int end   = std::min(n, begin + 64);
+        for (int i = begin; i < end; i++) {
+            double *row = &correlation[(long)i * n];
+            const double *vi = &ritzQ[(long)i * b];
+            for (int j = 0; j < n; j++) {
+                const double *vj = &ritzQ[(long)j * b];
+                double value = i == j ? noise : 0;
+                for (int k = 0; k < signal; k++) value += (eigenvalues[k] - noise) * vi[k] * vj[k];
+                row[j] = value;
+            }
+        }
+    });
+    
+    vector<double> scale(n);
+    for (int i = 0; i < n; i++) scale[i] = correlation[(long)i * n + i] > 0 ? 1 / sqrt(correlation[(long)i * n + i]) : 0;
+    for (int i = 0; i < n; i++) {
+        double *row = &correlation[(long)i * n];
+        for (int j = 0; j < n; j++) row[j] = i == j ? 1 : std::max(-1.0, std::min(1.0, row[j] * scale[i] * scale[j]));
+    }
+}
+
+
+// W = C Q, by blocks of rows. Each row of W is a combination of the rows of Q, so the inner loop is over the b columns
+void RMTFilter::multiply(int n, int b, const vector<double> &matrix, const vector<double> &Q, vector<double> &W) const {
+    W.assign((long)n * b, 0);
+    Util::parallelFor((n + 63) / 64, threads, [&](int, int block) {
+        int begin = block * 64;
+        int end   = std::min(n, begin + 64);
+        for (int i = begin; i < end; i++) {
+            const double *row = &matrix[(long)i * n];
+            double *w = &W[(long)i * b];
+            for (int l = 0; l < n; l++) {
+                const double *q = &Q[(long)l * b];
+                double c = row[l];
+                for (int k = 0; k < b; k++) w[k] += c * q[k];
+            }
+        }
+    });
+}
+
+// Modified Gram-Schmidt on the columns, twice for stability
+void RMTFilter::orthonormalise(int n, int b, vector<double> &Q) {
+    for (int pass = 0; pass < 2; pass++) {
+        for (int c = 0; c < b; c++) {
+            for (int p = 0; p < c; p++) {
+                double d = 0;
+                for (int i = 0; i < n; i++) d += Q[(long)i * b + c] * Q[(long)i * b + p];
+                for (int i = 0; i < n; i++) Q[(long)i * b + c] -= d * Q[(long)i * b + p];
+            }
+            double norm = 0;
+            for (int i = 0; i < n; i++) norm += Q[(long)i * b + c] * Q[(long)i * b + c];
+            norm = sqrt(norm);
+            for (int i = 0; i < n; i++) Q[(long)i * b + c] = norm > 0 ? Q[(long)i * b + c] / norm : 0;
+        }
+    }
+}
+
+
+void RMTFilter::jacobi(int n, vector<double> &a, vector<double> &values, vector<double> &vectors) {
+    vector<double> v((long)n * n, 0);
+    for (int i = 0; i < n; i++) v[(long)i * n + i] = 1;
+
+    for (int sweep = 0; sweep < 100; sweep++) {
+        double off = 0;
+        double total = 0;
+        for (int p = 0; p < n; p++) {
+            for (int q = 0; q < n; q++) {
+                total += a[p * n + q] * a[p * n + q];
+                if (p != q) off += a[p * n + q] * a[p * n + q];
+            }
+        }
+        if (off <= 1e-30 * total) break;
+
+        for (int p = 0; p < n - 1; p++) {
+            for (int q = p + 1; q < n; q++) {
+                double apq = a[p * n + q];
+                if (fabs(apq) < 1e-300) continue;
+                double app = a[p * n + p];
+                double aqq = a[q * n + q];
+                double tau = (aqq - app) / (2 * apq);
+                double t   = (tau >= 0 ? 1 : -1) / (fabs(tau) + sqrt(1 + tau * tau));
+                double c   = 1 / sqrt(1 + t * t);
+                double s   = t * c;
+                
+                for (int k = 0; k < n; k++) {
+                    double akp = a[k * n + p];
+                    double akq = a[k * n + q];
+                    a[k * n + p] = c * akp - s * akq;
+                    a[k * n + q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < n; k++) {
+                    double apk = a[p * n + k];
+                    double aqk = a[q * n + k];
+                    a[p * n + k] = c * apk - s * aqk;
+                    a[q * n + k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < n; k++) {
+                    double vkp = v[(long)k * n + p];
+                    double vkq = v[(long)k * n + q];
+                    v[(long)k * n + p] = c * vkp - s * vkq;
+                    v[(long)k * n + q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+
+    // Sorted by decreasing eigenvalue
+    vector<std::pair<int, double>> order(n);
+    for (int i = 0; i < n; i++) order[i] = std::make_pair(i, a[i * n + i]);
+    std::stable_sort(order.begin(), order.end(), Util::sortPairDesc<int, double>());
+    values.resize(n);
+    vectors.resize((long)n * n);
+    for (int c = 0; c < n; c++) {
+        values[c] = order[c].second;
+        for (int k = 0; k < n; k++) vectors[(long)k * n + c] = v[(long)k * n + order[c].first];
+    }
+}
@@ -0,0 +1,65 @@
+/**
+ * RMTFilter.h
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef RMTFILTER_H
+#define RMTFILTER_H
+
+#include "Util.h"
+
+/**
+ * Random matrix theory denoising of a correlation matrix estimated from T 
+ * periods. Eigenvalues below the Marchenko-Pastur edge (1 + sqrt(N/T))^2 are 
+ * noise: they are replaced by their mean, which preserves the trace, and the 
+ * result is rescaled to a unit diagonal. Only the eigenpairs above the edge 
+ * are needed, so they are found by subspace iteration with Rayleigh-Ritz 
+ * (the small projected problems solved by Jacobi), the block growing until 
+ * it holds every eigenvalue above the edge. Products with the matrix, the 
+ * only O(N^2) step, run on threads.
+ */
+class RMTFilter {
+
+    private:
+
+        int numPeriods;
+        int threads;
+        int maxIterations;
+        double tolerance;       // residual, relative to the largest eigenvalue, of the pair that ends the signal
+        double signalTolerance; // residual of the pairs above the edge, whose vectors make the filtered matrix
+
+        // Results of the last call
+        double         edge;
+        vector<double> eigenvalues;  // above the edge, decreasing
+        int            iterations;
+        bool           converged;    // false if maxIterations was reached first
+
+        // Q and W are n x b row-major
+        void multiply(int n, int b, const vector<double> &matrix, const vector<double> &Q, vector<double> &W) const;
+        static void orthonormalise(int n, int b, vector<double> &Q);
+
+    public:
+
+        RMTFilter();
+        ~RMTFilter();
+
+        void setParameters(int numPeriods, int threads) { this->numPeriods = numPeriods; this->threads = threads; }
+
+        // correlation is n x n row-major, replaced by its filtered version
+        void denoise(int n, vector<double> &correlation);
+
+        double getEdge()      const { return edge; }
+        int    getNumSignal() const { return eigenvalues.size(); }
+        int    getIterations() const { return iterations; }
+        bool   hasConverged()  const { return converged; }
+        const vector<double> &getEigenvalues() const { return eigenvalues; }
+
+        // Eigenvalues (decreasing) and eigenvectors (columns of the n x n row-major vectors) 
+        // of the symmetric n x n row-major a, by cyclic Jacobi rotations. a is destroyed.
+        static void jacobi(int n, vector<double> &a, vector<double> &values, vector<double> &vectors);
+};
+
+#endif
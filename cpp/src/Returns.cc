@@ -0,0 +1,214 @@
+/**
+ * Returns.cc
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "Returns.h"
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RETURNS_X86
+#include <immintrin.h>
+#endif
+
+typedef double (*DotKernel)(const double* a, const double* b, int n);
+typedef double (*WeightedDotKernel)(const double* a, const double* b, const double* w, int n);
+
+static double dotScalar(const double* a, const double* b, int n) {
+    double sum = 0;
+    for (int k = 0; k < n; k++) sum += a[k] * b[k];
+    return sum;
+}
+
+static double weightedDotScalar(const double* a, const double* b, const double* w, int n) {
+    double sum = 0;
+    for (int k = 0; k < n; k++) sum += w[k] * a[k] * b[k];
+    return sum;
+}
+
+#ifdef RETURNS_X86
+// Four independent accumulators hide the latency of the fused multiply-adds
+__attribute__((target("avx2,fma")))
+static double dotAVX2(const double* a, const double* b, int n) {
+    __m256d s0 = _mm256_setzero_pd();
+    __m256d s1 = _mm256_setzero_pd();
+    __m256d s2 = _mm256_setzero_pd();
+    __m256d s3 = _mm256_setzero_pd();
+    int k = 0;
+    for (; k + 16 <= n; k += 16) {
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + k),      _mm256_loadu_pd(b + k),      s0);
+        s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + k + 4),  _mm256_loadu_pd(b + k + 4),  s1);
+        s2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + k + 8),  _mm256_loadu_pd(b + k + 8),  s2);
+        s3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + k + 12), _mm256_loadu_pd(b + k + 12), s3);
+    }
+    for (; k + 4 <= n; k += 4) s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + k), _mm256_loadu_pd(b + k), s0);
+    
+    __m256d s = _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3));
+    double lanes[4];
+    _mm256_storeu_pd(lanes, s);
+    double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; k < n; k++) sum += a[k] * b[k];
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+static double weightedDotAVX2(const double* a, const double* b, const double* w, int n) {
+    __m256d s0 = _mm256_setzero_pd();
+    __m256d s1 = _mm256_setzero_pd();
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        s0 = _mm256_fmadd_pd(_mm256_mul_pd(_mm256_loadu_pd(w + k),     _mm256_loadu_pd(a + k)),     _mm256_loadu_pd(b + k),     s0);
+        s1 = _mm256_fmadd_pd(_mm256_mul_pd(_mm256_loadu_pd(w + k + 4), _mm256_loadu_pd(a + k + 4)), _mm256_loadu_pd(b + k + 4), s1);
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(s0, s1));
+    double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; k < n; k++) sum += w[k] * a[k] * b[k];
+    return sum;
+}
+#endif
+
+static DotKernel selectKernel(const char** name) {
+#ifdef RETURNS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) { *name = "avx2"; return dotAVX2; }
+#endif
+    *name = "scalar";
+    return dotScalar;
+}
+
+static WeightedDotKernel selectWeightedKernel() {
+#ifdef RETURNS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return weightedDotAVX2;
+#endif
+    return weightedDotScalar;
+}
+
+static const char*       kernelName  = "";
+static DotKernel         dot         = selectKernel(&kernelName);
+static WeightedDotKernel weightedDot = selectWeightedKernel();
+
+
+Returns::Returns() {
+    numPeriods = 0;
+    numAssets  = 0;
+}
+
+Returns::~Returns() {
+}
+
+void Returns::readData(const string &inputFile) {
+    int T = 0;
+    int N = 0;
+    vector<double> returns;
+    readFile(inputFile, T, N, returns);
+    setReturns(T, N, returns);
+}
+
+void Returns::readFile(const string &inputFile, int &numPeriods, int &numAssets, vector<double> &returns) {
+    FILE* file;
+    if (!Util::openFile(&file, inputFile.c_str(), "r")) 
+        Util::throwInvalidArgument("Error: Input file '%s' was not found or could not be opened.", inputFile.c_str());
+
+    try {
+        if (fscanf(file, "%d %d", &numPeriods, &numAssets) != 2 || numPeriods < 2 || numAssets < 1) Util::throwInvalidArgument("");
+        returns.resize((long)numPeriods * numAssets);
+        for (long k = 0; k < (long)numPeriods * numAssets; k++) {
+            if (fscanf(file, "%lf", &returns[k]) != 1) Util::throwInvalidArgument("");
+        }
+    } catch ( const std::invalid_argument& e) {
+        if (!Util::closeFile(&file)) Util::throwInvalidArgument("Error: File %s could not be closed.", inputFile.c_str());
+        Util::throwInvalidArgument("Error: File '%s' is invalid.", inputFile.c_str());
+    }
+    if (!Util::closeFile(&file)) Util::throwInvalidArgument("Error: File %s could not be closed.", inputFile.c_str());
+}
+
+// Constant assets are left as zero columns: correlation 0 with everything
+void Returns::setReturns(int numPeriods, int numAssets, const vector<double> &returns) {
+    if ((long)returns.size() < (long)numPeriods * numAssets) 
+        Util::throwInvalidArgument("Error in Returns: %d x %d returns expected, %d found.", numPeriods, numAssets, (int)returns.size());
+    this->numPeriods = numPeriods;
+    this->numAssets  = numAssets;
+    
+    columns.resize((long)numPeriods * numAssets);
+    for (int i = 0; i < numAssets; i++) {
+        double *column = &columns[(long)i * numPeriods];
+        for (int t = 0; t < numPeriods; t++) column[t] = returns[(long)t * numAssets + i];
+        standardise(column, numPeriods);
+    }
+}
+
+void Returns::setColumns(int numPeriods, const vector<const double*> &returns) {
+    this->numPeriods = numPeriods;
+    this->numAssets  = returns.size();
+
+    columns.resize((long)numPeriods * numAssets);
+    for (int i = 0; i < numAssets; i++) {
+        double *column = &columns[(long)i * numPeriods];
+        std::copy(returns[i], returns[i] + numPeriods, column);
+        standardise(column, numPeriods);
+    }
+}
+
+void Returns::standardise(double *column, int numPeriods) {
+    double mean = 0;
+    for (int t = 0; t < numPeriods; t++) mean += column[t];
+    mean /= numPeriods;
+    
+    double norm = 0;
+    for (int t = 0; t < numPeriods; t++) {
+        column[t] -= mean;
+        norm += column[t] * column[t];
+    }
+    norm = sqrt(norm);
+    for (int t = 0; t < numPeriods; t++) column[t] = norm > 0 ? column[t] / norm : 0;
+}
+
+double Returns::getCorrelation(int i, int j) const {
+    if (i == j) return 1;
+    double rho = dot(getColumn(i), getColumn(j), numPeriods);
+    return std::max(-1.0, std::min(1.0, rho));
+}
+
+double Returns::getDistance(int i, int j) const {
+    if (i == j) return 0;
+    return sqrt(2 * (1 - getCorrelation(i, j)));
+}
+
+void Returns::getDistanceRow(int u, int begin, int end, const double *skip, double *row) const {
+    const double *a = getColumn(u);
+    for (int v = begin; v < end; v++) {
+        if (skip != NULL && skip[v] != 0) {
+            row[v - begin] = 0;
+            continue;
+        }
+        double rho = v == u ? 1 : std::max(-1.0, std::min(1.0, dot(a, getColumn(v), numPeriods)));
+        row[v - begin] = sqrt(2 * (1 - rho));
+    }
+}
+
+void Returns::getWeightedMoments(const double *weights, double *mean, double *scale) const {
+    for (int i = 0; i < numAssets; i++) {
+        const double *column = getColumn(i);
+        double sum = 0;
+        for (int t = 0; t < numPeriods; t++) sum += weights[t] * column[t];
+        mean[i] = sum / numPeriods;
+        double variance = weightedDot(column, column, weights, numPeriods) / numPeriods - mean[i] * mean[i];
+        scale[i] = variance > 0 ? sqrt(variance) : 0;
+    }
+}
+
+double Returns::getWeightedCorrelation(int i, int j, const double *weights, const double *mean, const double *scale) const {
+    if (i == j) return 1;
+    if (scale[i] == 0 || scale[j] == 0) return 0;
+    double covariance = weightedDot(getColumn(i), getColumn(j), weights, numPeriods) / numPeriods - mean[i] * mean[j];
+    return std::max(-1.0, std::min(1.0, covariance / (scale[i] * scale[j])));
+}
+
+const char* Returns::getKernelName() {
+    return kernelName;
+}
@@ -0,0 +1,63 @@
+/**
+ * Returns.h
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef RETURNS_H
+#define RETURNS_H
+
+#include "Util.h"
+
+/**
+ * Returns of N assets over T periods, kept standardised column by column 
+ * (zero mean, unit norm), so that the correlation of two assets is the dot
+ * product of their columns. Memory is O(N T): distances are computed when 
+ * needed instead of storing the N x N matrix.
+ */
+class Returns {
+
+    private:
+
+        int numPeriods;
+        int numAssets;
+        vector<double> columns; // asset i is columns[i*T..(i+1)*T)
+
+        static void standardise(double *column, int numPeriods);
+
+    public:
+
+        Returns();
+        ~Returns();
+
+        // File: T and N, then T rows of N returns
+        void readData(const string &inputFile);
+        // Reads the file as is, T x N row-major
+        static void readFile(const string &inputFile, int &numPeriods, int &numAssets, vector<double> &returns);
+        // returns is T x N row-major, as in the file
+        void setReturns(int numPeriods, int numAssets, const vector<double> &returns);
+        // One pointer to numPeriods returns per asset, such as the columns of a ReturnsWindow
+        void setColumns(int numPeriods, const vector<const double*> &returns);
+
+        int getNumPeriods() const { return numPeriods; }
+        int getNumAssets()  const { return numAssets;  }
+        const double* getColumn(int i) const { return &columns[(long)i * numPeriods]; }
+
+        double getCorrelation(int i, int j) const;
+        // Mantegna distance sqrt(2 (1 - rho)), as stored in the correlation files
+        double getDistance(int i, int j) const;
+        // row[v - begin] = distance(u, v) for v in [begin, end), skipping the v with skip[v] set
+        void getDistanceRow(int u, int begin, int end, const double *skip, double *row) const;
+
+        // Moments of a resample given by the multiplicity of every period (weights[t], summing to T),
+        // without copying the returns: mean and scale (standard deviation) of every asset, then 
+        // the correlation of i and j in the resample
+        void   getWeightedMoments(const double *weights, double *mean, double *scale) const;
+        double getWeightedCorrelation(int i, int j, const double *weights, const double *mean, const double *scale) const;
+
+        static const char* getKernelName();
+};
+
+#endif
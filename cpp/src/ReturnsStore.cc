@@ -0,0 +1,395 @@
+/**
+ * ReturnsStore.cc
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "ReturnsStore.h"
+#include <cmath>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RETURNSSTORE_X86
+#include <immintrin.h>
+#endif
+
+static const char    STORE_MAGIC[8] = {'R', 'E', 'T', 'S', 'T', 'O', 'R', 'E'};
+static const int32_t STORE_VERSION  = 2;
+
+// Bit k of zeros (missing) is set if a[k] is zero (NaN), n <= 64
+typedef void (*MaskKernel)(const double* a, int n, uint64_t* zeros, uint64_t* missing);
+
+static void maskScalar(const double* a, int n, uint64_t* zeros, uint64_t* missing) {
+    uint64_t z = 0;
+    uint64_t m = 0;
+    for (int k = 0; k < n; k++) {
+        if (a[k] == 0)     z |= (uint64_t)1 << k;
+        if (a[k] != a[k])  m |= (uint64_t)1 << k;
+    }
+    *zeros   = z;
+    *missing = m;
+}
+
+#ifdef RETURNSSTORE_X86
+__attribute__((target("avx2")))
+static void maskAVX2(const double* a, int n, uint64_t* zeros, uint64_t* missing) {
+    const __m256d zero = _mm256_setzero_pd();
+    uint64_t z = 0;
+    uint64_t m = 0;
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m256d v = _mm256_loadu_pd(a + k);
+        z |= (uint64_t)_mm256_movemask_pd(_mm256_cmp_pd(v, zero, _CMP_EQ_OQ)) << k;
+        m |= (uint64_t)_mm256_movemask_pd(_mm256_cmp_pd(v, v,    _CMP_UNORD_Q)) << k;
+    }
+    for (; k < n; k++) {
+        if (a[k] == 0)     z |= (uint64_t)1 << k;
+        if (a[k] != a[k])  m |= (uint64_t)1 << k;
+    }
+    *zeros   = z;
+    *missing = m;
+}
+#endif
+
+static MaskKernel selectKernel(const char** name) {
+#ifdef RETURNSSTORE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) { *name = "avx2"; return maskAVX2; }
+#endif
+    *name = "scalar";
+    return maskScalar;
+}
+
+static const char* kernelName = "";
+static MaskKernel  mask       = selectKernel(&kernelName);
+
+
+const double* ReturnsWindow::getColumn(int k) const {
+    return store->getColumn(assets[k]) + begin;
+}
+
+vector<const double*> ReturnsWindow::getColumns() const {
+    vector<const double*> result(assets.size());
+    for (unsigned k = 0; k < assets.size(); k++) result[k] = getColumn(k);
+    return result;
+}
+
+
+ReturnsStore::ReturnsStore() {
+    base    = NULL;
+    size    = 0;
+    heap    = false;
+    header  = NULL;
+    dates   = NULL;
+    columns = NULL;
+    prices  = NULL;
+}
+
+ReturnsStore::~ReturnsStore() {
+    close();
+}
+
+void ReturnsStore::create(const string &file, const vector<string> &names, const vector<int> &dates, const vector<double> &columns, 
+                          int capacity, const vector<double> &lastPrices) {
+    int N = names.size();
+    int T = dates.size();
+    if ((long)columns.size() != (long)N * T)
+        Util::throwInvalidArgument("Error in ReturnsStore: %d x %d returns expected, %d found.", N, T, (int)columns.size());
+    if (!lastPrices.empty() && (int)lastPrices.size() != N)
+        Util::throwInvalidArgument("Error in ReturnsStore: %d last prices expected, %d found.", N, (int)lastPrices.size());
+    for (int t = 1; t < T; t++) {
+        if (dates[t] <= dates[t-1]) Util::throwInvalidArgument("Error in ReturnsStore: dates must be increasing (%d after %d).", dates[t], dates[t-1]);
+    }
+
+    capacity = (std::max(std::max(capacity, T), 1) + 7) / 8 * 8;
+
+    Header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, STORE_MAGIC, sizeof(h.magic));
+    h.version       = STORE_VERSION;
+    h.numAssets     = N;
+    h.numDates      = T;
+    h.capacity      = capacity;
+    h.datesOffset   = sizeof(Header);
+    h.columnsOffset = (h.datesOffset + (int64_t)capacity * sizeof(int32_t) + 63) / 64 * 64;
+    h.namesOffset   = h.columnsOffset + (int64_t)N * capacity * sizeof(double);
+    h.namesSize     = 0;
+    for (int i = 0; i < N; i++) h.namesSize += names[i].size() + 1;
+    h.pricesOffset  = (h.namesOffset + h.namesSize + 7) / 8 * 8;
+
+    FILE* out;
+    if (!Util::openFile(&out, file.c_str(), "wb")) Util::throwInvalidArgument("Error: File '%s' could not be created.", file.c_str());
+
+    bool ok = fwrite(&h, sizeof(h), 1, out) == 1;
+
+    vector<int32_t> paddedDates(capacity, 0);
+    for (int t = 0; t < T; t++) paddedDates[t] = dates[t];
+    ok = ok && fwrite(&paddedDates[0], sizeof(int32_t), capacity, out) == (size_t)capacity;
+
+    vector<char> gap(h.columnsOffset - h.datesOffset - (int64_t)capacity * sizeof(int32_t), 0);
+    if (!gap.empty()) ok = ok && fwrite(&gap[0], 1, gap.size(), out) == gap.size();
+
+    // Slack after the last date is NaN, as missing returns
+    vector<double> column(capacity, std::numeric_limits<double>::quiet_NaN());
+    for (int i = 0; i < N && ok; i++) {
+        if (T > 0) memcpy(&column[0], &columns[(long)i * T], T * sizeof(double));
+        ok = fwrite(&column[0], sizeof(double), capacity, out) == (size_t)capacity;
+    }
+    for (int i = 0; i < N && ok; i++) ok = fwrite(names[i].c_str(), 1, names[i].size() + 1, out) == names[i].size() + 1;
+
+    vector<char> namesGap(h.pricesOffset - h.namesOffset - h.namesSize, 0);
+    if (!namesGap.empty()) ok = ok && fwrite(&namesGap[0], 1, namesGap.size(), out) == namesGap.size();
+    vector<double> prices(lastPrices);
+    prices.resize(N, std::numeric_limits<double>::quiet_NaN());
+    if (N > 0) ok = ok && fwrite(&prices[0], sizeof(double), N, out) == (size_t)N;
+
+    if (!Util::closeFile(&out) || !ok) Util::throwInvalidArgument("Error: File '%s' could not be written.", file.c_str());
+}
+
+bool ReturnsStore::append(const string &file, const vector<string> &names, const vector<int> &dates, const vector<double> &columns, 
+                          const vector<double> &lastPrices) {
+    int M = names.size();
+    int D = dates.size();
+    if ((long)columns.size() != (long)M * D)
+        Util::throwInvalidArgument("Error in ReturnsStore: %d x %d returns expected, %d found.", M, D, (int)columns.size());
+    if (!lastPrices.empty() && (int)lastPrices.size() != M)
+        Util::throwInvalidArgument("Error in ReturnsStore: %d last prices expected, %d found.", M, (int)lastPrices.size());
+    if (D == 0) return true;
+
+    ReturnsStore store;
+    store.open(file);
+    int N = store.getNumAssets();
+    int T = store.getNumDates();
+    if (T > 0 && dates[0] <= store.getDate(T - 1))
+        Util::throwInvalidArgument("Error in ReturnsStore: date %d is not after the last date of '%s' (%d).", dates[0], file.c_str(), store.getDate(T - 1));
+    for (int d = 1; d < D; d++) {
+        if (dates[d] <= dates[d-1]) Util::throwInvalidArgument("Error in ReturnsStore: dates must be increasing (%d after %d).", dates[d], dates[d-1]);
+    }
+
+    vector<int> position(M);
+    int added = 0;
+    for (int k = 0; k < M; k++) {
+        position[k] = store.findAsset(names[k]);
+        if (position[k] < 0) position[k] = N + added++;
+    }
+
+    // The prices on the new last date: NaN for the assets not in names
+    vector<double> allPrices(N + added, std::numeric_limits<double>::quiet_NaN());
+    for (int k = 0; k < M && !lastPrices.empty(); k++) allPrices[position[k]] = lastPrices[k];
+
+    // Version 1 files have no room for the prices and are rebuilt
+    if (added == 0 && T + D <= store.getCapacity() && store.header->pricesOffset != 0) {
+        Header h = *store.header;
+        store.close();
+
+        FILE* out;
+        if (!Util::openFile(&out, file.c_str(), "r+b")) Util::throwInvalidArgument("Error: File '%s' could not be opened for writing.", file.c_str());
+        vector<int32_t> newDates(dates.begin(), dates.end());
+        bool ok = fseek(out, h.datesOffset + (long)T * sizeof(int32_t), SEEK_SET) == 0 
+               && fwrite(&newDates[0], sizeof(int32_t), D, out) == (size_t)D;
+        // The slack of the assets not in names is NaN already
+        for (int k = 0; k < M && ok; k++) {
+            ok = fseek(out, h.columnsOffset + ((long)position[k] * h.capacity + T) * sizeof(double), SEEK_SET) == 0
+              && fwrite(&columns[(long)k * D], sizeof(double), D, out) == (size_t)D;
+        }
+        if (N > 0) ok = ok && fseek(out, h.pricesOffset, SEEK_SET) == 0 && fwrite(&allPrices[0], sizeof(double), N, out) == (size_t)N;
+        // The header goes last, so the dates only count once their returns are written
+        h.numDates = T + D;
+        ok = ok && fflush(out) == 0 && fseek(out, 0, SEEK_SET) == 0 && fwrite(&h, sizeof(h), 1, out) == 1;
+        if (!Util::closeFile(&out) || !ok) Util::throwInvalidArgument("Error: File '%s' could not be written.", file.c_str());
+        return true;
+    }
+
+    // Rebuilt with room for as many dates again, into a new file that then replaces the old one
+    vector<string> allNames(N + added);
+    for (int i = 0; i < N; i++) allNames[i] = store.getName(i);
+    for (int k = 0; k < M; k++) allNames[position[k]] = names[k];
+
+    vector<int> allDates(T + D);
+    for (int t = 0; t < T; t++) allDates[t] = store.getDate(t);
+    for (int d = 0; d < D; d++) allDates[T + d] = dates[d];
+
+    long length = T + D;
+    vector<double> all((long)(N + added) * length, std::numeric_limits<double>::quiet_NaN());
+    for (int i = 0; i < N; i++) std::copy(store.getColumn(i), store.getColumn(i) + T, &all[(long)i * length]);
+    for (int k = 0; k < M; k++) std::copy(&columns[(long)k * D], &columns[(long)k * D] + D, &all[(long)position[k] * length + T]);
+    store.close();
+
+    string temporary = file + ".tmp";
+    create(temporary, allNames, allDates, all, 2 * (T + D), allPrices);
+    if (rename(temporary.c_str(), file.c_str()) != 0) {
+        remove(temporary.c_str());
+        Util::throwInvalidArgument("Error: File '%s' could not be replaced.", file.c_str());
+    }
+    return false;
+}
+
+bool ReturnsStore::isStore(const string &file) {
+    FILE* in;
+    if (!Util::openFile(&in, file.c_str(), "rb")) return false;
+    char magic[8];
+    bool result = fread(magic, 1, sizeof(magic), in) == sizeof(magic) && memcmp(magic, STORE_MAGIC, sizeof(magic)) == 0;
+    Util::closeFile(&in);
+    return result;
+}
+
+void ReturnsStore::open(const string &file) {
+    close();
+    fileName = file;
+
+#ifndef _WIN32
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0) Util::throwInvalidArgument("Error: Input file '%s' was not found or could not be opened.", file.c_str());
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        Util::throwInvalidArgument("Error: Input file '%s' could not be read.", file.c_str());
+    }
+    size = st.st_size;
+    if (size >= sizeof(Header)) {
+        void* mapped = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped != MAP_FAILED) base = (char*)mapped;
+    }
+    ::close(fd);
+#else
+    FILE* in;
+    if (!Util::openFile(&in, file.c_str(), "rb")) Util::throwInvalidArgument("Error: Input file '%s' was not found or could not be opened.", file.c_str());
+    fseek(in, 0, SEEK_END);
+    size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    if (size >= sizeof(Header)) {
+        base = (char*)malloc(size);
+        heap = true;
+        if (fread(base, 1, size, in) != size) size = 0;
+    }
+    Util::closeFile(&in);
+#endif
+    if (base == NULL) Util::throwInvalidArgument("Error: File '%s' is not a returns store.", file.c_str());
+
+    const Header* h = (const Header*)base;
+    bool valid = memcmp(h->magic, STORE_MAGIC, sizeof(h->magic)) == 0 && h->version >= 1 && h->version <= STORE_VERSION
+              && h->numAssets >= 0 && h->numDates >= 0 && h->numDates <= h->capacity
+              && h->columnsOffset >= h->datesOffset + (int64_t)h->capacity * (int64_t)sizeof(int32_t)
+              && h->namesOffset == h->columnsOffset + (int64_t)h->numAssets * h->capacity * (int64_t)sizeof(double)
+              && h->namesOffset + h->namesSize <= (int64_t)size
+              && (h->version < 2 || (h->pricesOffset >= h->namesOffset + h->namesSize && h->pricesOffset % 8 == 0
+                                     && h->pricesOffset + (int64_t)h->numAssets * (int64_t)sizeof(double) <= (int64_t)size));
+    if (!valid) {
+        close();
+        Util::throwInvalidArgument("Error: File '%s' is not a valid returns store.", file.c_str());
+    }
+
+    header  = h;
+    dates   = (const int32_t*)(base + h->datesOffset);
+    columns = (const double*)(base + h->columnsOffset);
+    prices  = h->version >= 2 ? (const double*)(base + h->pricesOffset) : NULL;
+
+    const char* name = base + h->namesOffset;
+    const char* end  = name + h->namesSize;
+    names.resize(h->numAssets);
+    for (int i = 0; i < h->numAssets; i++) {
+        const char* next = (const char*)memchr(name, 0, end - name);
+        if (next == NULL) {
+            close();
+            Util::throwInvalidArgument("Error: File '%s' is not a valid returns store.", file.c_str());
+        }
+        names[i].assign(name, next);
+        nameIndex[names[i]] = i;
+        name = next + 1;
+    }
+}
+
+void ReturnsStore::close() {
+    if (base != NULL) {
+#ifndef _WIN32
+        if (!heap) munmap(base, size);
+#endif
+        if (heap) free(base);
+    }
+    base    = NULL;
+    size    = 0;
+    heap    = false;
+    header  = NULL;
+    dates   = NULL;
+    columns = NULL;
+    prices  = NULL;
+    names.clear();
+    nameIndex.clear();
+}
+
+int ReturnsStore::findAsset(const string &name) const {
+    map<string, int>::const_iterator it = nameIndex.find(name);
+    return it == nameIndex.end() ? -1 : it->second;
+}
+
+ReturnsWindow ReturnsStore::getWindow(int beginDate, int endDate, const vector<char>* universe) const {
+    if (header == NULL) Util::throwInvalidArgument("Error in ReturnsStore: no store is open.");
+    if (universe != NULL && (int)universe->size() != header->numAssets)
+        Util::throwInvalidArgument("Error in ReturnsStore: universe of %d assets, store has %d.", (int)universe->size(), header->numAssets);
+
+    int T = header->numDates;
+    int first = beginDate > 0 ? std::lower_bound(dates, dates + T, beginDate) - dates : 0;
+    int last  = endDate   > 0 ? std::upper_bound(dates, dates + T, endDate)   - dates : T;
+
+    ReturnsWindow window;
+    window.store      = this;
+    window.begin      = first;
+    window.numPeriods = std::max(0, last - first);
+    for (int i = 0; i < header->numAssets; i++) {
+        if (universe == NULL || (*universe)[i]) window.assets.push_back(i);
+    }
+    return window;
+}
+
+
+// The columns are scanned 64 returns at a time: the zero returns are a bit mask, and a run
+// of zeros either continues through a whole word or is found from the bit counts of the word
+int ReturnsStore::getMaxZeroRun(const double* column, int n) {
+    int best = 0;
+    int run  = 0;
+    for (int start = 0; start < n; start += 64) {
+        int valid = std::min(64, n - start);
+        uint64_t zeros, missing;
+        mask(column + start, valid, &zeros, &missing);
+        if (missing != 0) return -1;
+
+        uint64_t full = valid == 64 ? ~(uint64_t)0 : ((uint64_t)1 << valid) - 1;
+        if (zeros == full) {
+            run += valid;
+            continue;
+        }
+        uint64_t nonZero = ~zeros & full;
+        run += __builtin_ctzll(nonZero);
+        best = std::max(best, run);
+
+        // Longest run inside the word: each step shortens every run by one
+        int inner = 0;
+        for (uint64_t x = zeros; x != 0; x &= x >> 1) inner++;
+        best = std::max(best, inner);
+
+        run = valid - 1 - (63 - __builtin_clzll(nonZero));
+    }
+    return std::max(best, run);
+}
+
+void ReturnsStore::filterLiquid(ReturnsWindow &window, int maxZeroRun) {
+    unsigned kept = 0;
+    for (unsigned k = 0; k < window.assets.size(); k++) {
+        int run = getMaxZeroRun(window.getColumn(k), window.numPeriods);
+        if (run >= 0 && run <= maxZeroRun) window.assets[kept++] = window.assets[k];
+    }
+    window.assets.resize(kept);
+}
+
+const char* ReturnsStore::getKernelName() {
+    return kernelName;
+}
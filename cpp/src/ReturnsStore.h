@@ -0,0 +1,123 @@
+/**
+ * ReturnsStore.h
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef RETURNSSTORE_H
+#define RETURNSSTORE_H
+
+#include "Util.h"
+#include <stdint.h>
+
+class ReturnsStore;
+
+/**
+ * Periods [begin, begin + numPeriods) of some assets of a store. Columns
+ * point into the mapped file, nothing is copied.
+ */
+class ReturnsWindow {
+
+    public:
+
+        const ReturnsStore* store;
+        int begin;
+        int numPeriods;
+        vector<int> assets; // indices in the store
+
+        ReturnsWindow() { store = NULL; begin = 0; numPeriods = 0; }
+
+        int getNumAssets() const { return assets.size(); }
+        const double* getColumn(int k) const;
+        vector<const double*> getColumns() const;
+};
+
+
+/**
+ * Daily returns of N assets, one column per asset, in a binary file that is
+ * memory mapped rather than read. Dates are YYYYMMDD and increasing. Missing
+ * returns (the asset was not listed) are NaN. Every column has room for
+ * capacity dates, so new dates can be appended in place. The price of each 
+ * asset on the last date is kept as well, so that the first return appended
+ * needs no price from before it.
+ *
+ * Layout: header, dates (capacity int32), columns (N x capacity doubles,
+ * each 64-byte aligned), names (NUL terminated), last prices (N doubles, 
+ * 8-byte aligned; absent in version 1 files, whose last prices are NaN).
+ */
+class ReturnsStore {
+
+    public:
+
+        struct Header {
+            char    magic[8];
+            int32_t version;
+            int32_t numAssets;
+            int32_t numDates;
+            int32_t capacity;
+            int64_t datesOffset;
+            int64_t columnsOffset;
+            int64_t namesOffset;
+            int64_t namesSize;
+            int64_t pricesOffset; // 0 if there are no last prices
+        };
+
+    private:
+
+        string fileName;
+        char*  base;
+        size_t size;
+        bool   heap; // no mmap: the file was read into memory
+
+        const Header*  header;
+        const int32_t* dates;
+        const double*  columns;
+        const double*  prices;
+        vector<string> names;
+        map<string, int> nameIndex;
+
+    public:
+
+        ReturnsStore();
+        ~ReturnsStore();
+
+        // columns is N x T column-major, capacity is rounded up to a multiple of 8 and at least T.
+        // lastPrices are the prices on the last date (empty for none)
+        static void create(const string &file, const vector<string> &names, const vector<int> &dates, const vector<double> &columns, 
+                           int capacity = 0, const vector<double> &lastPrices = vector<double>());
+        static bool isStore(const string &file);
+        // Adds dates after the last one (columns is names.size() x dates.size() column-major). Assets 
+        // of the store missing from names get NaN, new names get NaN before the new dates. Written in 
+        // place when the columns have room and no asset is new, otherwise the file is rebuilt. 
+        // lastPrices are those of names on the last new date, the other assets get NaN.
+        // Returns true if written in place.
+        static bool append(const string &file, const vector<string> &names, const vector<int> &dates, const vector<double> &columns, 
+                           const vector<double> &lastPrices = vector<double>());
+
+        void open(const string &file);
+        void close();
+
+        int getNumAssets() const { return header == NULL ? 0 : header->numAssets; }
+        int getNumDates()  const { return header == NULL ? 0 : header->numDates;  }
+        int getCapacity()  const { return header == NULL ? 0 : header->capacity;  }
+        int getDate(int t) const { return dates[t]; }
+        const string& getName(int i) const { return names[i]; }
+        const double* getColumn(int i) const { return columns + (long)i * header->capacity; }
+        // Price on the last date, NaN if unknown
+        double getLastPrice(int i) const { return prices != NULL ? prices[i] : std::numeric_limits<double>::quiet_NaN(); }
+        // -1 if not in the store
+        int findAsset(const string &name) const;
+
+        // Dates in [beginDate, endDate] (0 for no limit) of the assets with universe[i] set (NULL for every asset)
+        ReturnsWindow getWindow(int beginDate, int endDate, const vector<char>* universe = NULL) const;
+
+        // Keeps the assets of the window with no missing return and no more than maxZeroRun zero returns in a row
+        static void filterLiquid(ReturnsWindow &window, int maxZeroRun);
+        // Longest run of zero returns, -1 if some return is missing
+        static int  getMaxZeroRun(const double* column, int n);
+        static const char* getKernelName();
+};
+
+#endif
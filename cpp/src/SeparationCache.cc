@@ -0,0 +1,76 @@
+/**
+ * SeparationCache.cc
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "SeparationCache.h"
+
+SeparationCache::SeparationCache() {
+    capacity = 0;
+}
+
+SeparationCache::~SeparationCache() {
+}
+
+void SeparationCache::initialise(int capacity) {
+    this->capacity = capacity;
+    clear();
+}
+
+void SeparationCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+}
+
+// FNV-1a over the words of the bitset
+unsigned long long SeparationCache::hash(const vector<unsigned long long> &support) {
+    unsigned long long h = 14695981039346656037ULL;
+    for (unsigned w = 0; w < support.size(); w++) {
+        h = (h ^ support[w]) * 1099511628211ULL;
+        h = (h ^ (support[w] >> 32)) * 1099511628211ULL;
+    }
+    return h;
+}
+
+bool SeparationCache::find(const vector<unsigned long long> &support, unsigned long long key, vector<SolverCut> &cuts) {
+    if (capacity == 0) return false;
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if (it == index.end() || it->second->support != support) return false;
+
+    // Most recently used at the front
+    entries.splice(entries.begin(), entries, it->second);
+    cuts = it->second->cuts;
+    return true;
+}
+
+void SeparationCache::insert(const vector<unsigned long long> &support, unsigned long long key, const vector<SolverCut> &cuts) {
+    if (capacity == 0) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        // Same key, either the same support or a collision: the new one replaces it
+        it->second->support = support;
+        it->second->cuts    = cuts;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+
+    if ((int)entries.size() >= capacity) {
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+
+    Entry entry;
+    entry.key     = key;
+    entry.support = support;
+    entry.cuts    = cuts;
+    entries.push_front(entry);
+    index[key] = entries.begin();
+}
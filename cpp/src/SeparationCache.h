@@ -0,0 +1,59 @@
+/**
+ * SeparationCache.h
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef SEPARATIONCACHE_H
+#define SEPARATIONCACHE_H
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include "Util.h"
+#include "Solver.h"
+
+/**
+ * Least recently used cache of the cuts found at integer points. The solver 
+ * often checks the same candidate more than once (heuristics, several threads),
+ * and at an integer point the cuts depend only on which variables are one.
+ * The key is that support as a bitset; an empty list of cuts means that the 
+ * point was found feasible. Shared by all threads.
+ */
+class SeparationCache {
+
+    private:
+
+        struct Entry {
+            unsigned long long         key;
+            vector<unsigned long long> support;
+            vector<SolverCut>          cuts;
+        };
+
+        int capacity;
+        std::list<Entry> entries;
+        std::unordered_map<unsigned long long, std::list<Entry>::iterator> index;
+        std::mutex mutex;
+
+    public:
+
+        SeparationCache();
+        ~SeparationCache();
+
+        // A capacity of zero disables the cache
+        void initialise(int capacity);
+        void clear();
+
+        static unsigned long long hash(const vector<unsigned long long> &support);
+        
+        // Returns true and fills cuts if the support is in the cache
+        bool find(const vector<unsigned long long> &support, unsigned long long key, vector<SolverCut> &cuts);
+        void insert(const vector<unsigned long long> &support, unsigned long long key, const vector<SolverCut> &cuts);
+
+        bool isEnabled()  const { return capacity > 0; }
+        int  getSize()          { return (int)entries.size(); }
+};
+
+#endif
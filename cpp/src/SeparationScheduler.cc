@@ -0,0 +1,111 @@
+/**
+ * SeparationScheduler.cc
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "SeparationScheduler.h"
+
+// Weight of the last round in the moving averages
+#define SCHEDULER_ALPHA     0.1
+
+// Relative bound change below which the rounds at a node are tailing off
+#define SCHEDULER_TAILING   1e-4
+
+// Rounds allowed at the root and at any other node
+#define SCHEDULER_ROOT_ROUNDS 100
+#define SCHEDULER_NODE_ROUNDS 10
+
+SeparationScheduler::SeparationScheduler() {
+    initialise(false);
+}
+
+SeparationScheduler::~SeparationScheduler() {
+}
+
+void SeparationScheduler::initialise(bool fractional) {
+    this->fractional = fractional;
+
+    node           = -1;
+    roundsAtNode   = 0;
+    lastBound      = 0;
+    tailingOff     = false;
+    separateNode   = true;
+    nodesSeen      = 0;
+
+    // Optimistic start, so that the first nodes are separated
+    yield          = 1;
+    violation      = 0;
+    roundWork      = 0;
+    boundGain      = 0;
+    rootEfficiency = 0;
+}
+
+void SeparationScheduler::startNode(const SeparationContext &context) {
+    node         = context.node;
+    roundsAtNode = 0;
+    lastBound    = context.nodeBound;
+    tailingOff   = false;
+    nodesSeen++;
+    
+    if (context.depth <= 0) {
+        separateNode = true;
+        return;
+    }
+
+    // Separate one node out of interval, more often while the cuts pay off
+    int interval = 1;
+    if      (yield < 0.1) interval = 8;
+    else if (yield < 0.5) interval = 2;
+    if (context.depth > 20) interval *= 2;
+    
+    // Cuts per unit of work compared with the root
+    if (rootEfficiency > 0 && roundWork > 0 && yield * violation / roundWork < 0.05 * rootEfficiency) interval *= 2;
+
+    separateNode = (nodesSeen % interval == 0);
+}
+
+SeparationPlan SeparationScheduler::plan(const SeparationContext &context) {
+    SeparationPlan plan;
+    plan.components = true;
+    plan.maxFlow    = false;
+    plan.maxCuts    = 0;
+
+    if (context.candidate || !fractional) return plan;
+
+    if (context.node != node || context.node == -1) {
+        startNode(context);
+    } else {
+        double gain = fabs(context.nodeBound - lastBound) / std::max(1.0, fabs(lastBound));
+        boundGain   = (1 - SCHEDULER_ALPHA) * boundGain + SCHEDULER_ALPHA * gain;
+        lastBound   = context.nodeBound;
+        if (roundsAtNode >= 2 && gain < SCHEDULER_TAILING) tailingOff = true;
+    }
+
+    int maxRounds = context.depth <= 0 ? SCHEDULER_ROOT_ROUNDS : SCHEDULER_NODE_ROUNDS;
+    if (!separateNode || tailingOff || roundsAtNode >= maxRounds) {
+        plan.components = false;
+        return plan;
+    }
+
+    plan.maxFlow = true;
+    if (context.depth > 0) plan.maxCuts = yield >= 1 ? 10 : 3;
+    return plan;
+}
+
+void SeparationScheduler::record(const SeparationContext &context, int numCuts, double maxViolation, long work) {
+    roundsAtNode++;
+    yield     = (1 - SCHEDULER_ALPHA) * yield     + SCHEDULER_ALPHA * numCuts;
+    roundWork = (1 - SCHEDULER_ALPHA) * roundWork + SCHEDULER_ALPHA * work;
+    if (numCuts > 0) violation = (1 - SCHEDULER_ALPHA) * violation + SCHEDULER_ALPHA * maxViolation;
+    
+    // Rounds stop finding cuts before the bound stops moving
+    if (numCuts == 0) tailingOff = true;
+    
+    if (context.depth <= 0 && work > 0 && numCuts > 0) {
+        double efficiency = numCuts * maxViolation / work;
+        rootEfficiency = (1 - SCHEDULER_ALPHA) * rootEfficiency + SCHEDULER_ALPHA * efficiency;
+    }
+}
@@ -0,0 +1,78 @@
+/**
+ * SeparationScheduler.h
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef SEPARATIONSCHEDULER_H
+#define SEPARATIONSCHEDULER_H
+
+#include "Util.h"
+#include "Solver.h"
+
+/**
+ * What one call of the separation algorithm should do
+ */
+struct SeparationPlan {
+    bool components;  // Connected components of the support graph (exact at integer points)
+    bool maxFlow;     // Rooted minimum cuts (exact at fractional points)
+    int  maxCuts;     // Max-flow stops after this many cuts, 0 for no limit
+};
+
+/**
+ * Decides, for every call of the separation algorithm, whether fractional
+ * separation is worth running and with how much effort. Integer candidates
+ * are always separated, since a violated cut cannot be skipped there.
+ *
+ * At fractional points it keeps moving averages of the cuts found per round, 
+ * their violation, the work per round and the bound change between rounds at 
+ * the same node. The root node is separated until the bound tails off; deeper 
+ * nodes are separated less often as the yield falls, with fewer rounds and 
+ * fewer cuts per round. Each solver thread owns one scheduler. Work is counted
+ * (support graph traversals) rather than timed, so that the plans, and the cuts,
+ * are the same in every run of the deterministic parallel mode.
+ */
+class SeparationScheduler {
+
+    private:
+
+        bool fractional;
+
+        // Current node
+        long   node;
+        int    roundsAtNode;
+        double lastBound;
+        bool   tailingOff;
+        bool   separateNode;
+        long   nodesSeen;
+
+        // Moving averages over the fractional rounds
+        double yield;
+        double violation;
+        double roundWork;
+        double boundGain;
+        double rootEfficiency;
+        
+        void startNode(const SeparationContext &context);
+
+    public:
+
+        SeparationScheduler();
+        ~SeparationScheduler();
+
+        // If fractional is false only integer candidates are separated (by components, 
+        // max-flow never runs)
+        void initialise(bool fractional);
+        
+        SeparationPlan plan(const SeparationContext &context);
+        
+        // Results of a fractional round, whatever family found its cuts
+        void record(const SeparationContext &context, int numCuts, double maxViolation, long work);
+
+        double getYield()     const { return yield;     }
+        double getBoundGain() const { return boundGain; }
+};
+
+#endif
@@ -0,0 +1,94 @@
+/**
+ * SeparationWorkspace.cc
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "SeparationWorkspace.h"
+
+SeparationWorkspace::SeparationWorkspace() {
+    N = 0;
+    numComponents = 0;
+}
+
+SeparationWorkspace::~SeparationWorkspace() {
+}
+
+void SeparationWorkspace::initialise(int N) {
+    this->N = N;
+    
+    newIndicesToOld.clear();
+    newIndicesToOld.reserve(N);
+    oldIndicesToNew.assign(N, -1);
+    y_sol.clear();
+    y_sol.reserve(N);
+
+    int E = N*(N-1)/2;
+    edgeFrom.clear();
+    edgeTo.clear();
+    edgeValue.clear();
+    edgeFrom.reserve(E);
+    edgeTo.reserve(E);
+    edgeValue.reserve(E);
+
+    marks.assign(N, 0);
+    int bitsetVertices = std::min(N, 256);
+    adjacencyBits.assign((long)bitsetVertices * AlgoUtil::bitsetWords(bitsetVertices), 0);
+    support.assign((N + E + 63) / 64, 0);
+
+    numComponents = 0;
+    componentStart.assign(N+1, 0);
+    componentVertices.resize(N);
+    componentOf.resize(N);
+}
+
+void SeparationWorkspace::reset() {
+    for (unsigned i = 0; i < newIndicesToOld.size(); i++) oldIndicesToNew[newIndicesToOld[i]] = -1;
+    newIndicesToOld.clear();
+    y_sol.clear();
+    
+    edgeFrom.clear();
+    edgeTo.clear();
+    edgeValue.clear();
+    
+    numComponents = 0;
+}
+
+int SeparationWorkspace::addVertex(int oldIndex, double y) {
+    int index = (int)newIndicesToOld.size();
+    newIndicesToOld.push_back(oldIndex);
+    y_sol.push_back(y);
+    oldIndicesToNew[oldIndex] = index;
+    return index;
+}
+
+void SeparationWorkspace::addEdge(int i, int j, double x) {
+    edgeFrom.push_back(i);
+    edgeTo.push_back(j);
+    edgeValue.push_back(x);
+}
+
+int SeparationWorkspace::findComponents() {
+    int n     = getNumVertices();
+    int words = AlgoUtil::bitsetWords(n);
+    if (words > 0) {
+        std::fill(adjacencyBits.begin(), adjacencyBits.begin() + (long)n * words, 0ULL);
+        for (unsigned e = 0; e < edgeFrom.size(); e++) {
+            int i = edgeFrom[e];
+            int j = edgeTo[e];
+            adjacencyBits[(long)i * words + (j >> 6)] |= 1ULL << (j & 63);
+            adjacencyBits[(long)j * words + (i >> 6)] |= 1ULL << (i & 63);
+        }
+        numComponents = AlgoUtil::connectedComponentsBitset(n, words, adjacencyBits, componentOf, componentStart, componentVertices);
+        return numComponents;
+    }
+
+    sets.initialise(n);
+    for (unsigned e = 0; e < edgeFrom.size(); e++) sets.unite(edgeFrom[e], edgeTo[e]);
+    
+    numComponents = sets.getNumSets();
+    if (numComponents > 1) sets.groupSets(componentOf, componentStart, componentVertices);
+    return numComponents;
+}
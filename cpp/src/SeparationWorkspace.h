@@ -0,0 +1,101 @@
+/**
+ * SeparationWorkspace.h
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef SEPARATIONWORKSPACE_H
+#define SEPARATIONWORKSPACE_H
+
+#include "Util.h"
+#include "AlgoUtil.h"
+#include "MaxFlow.h"
+#include "CutArena.h"
+
+/**
+ * Buffers used by one call of the separation algorithm. They are sized once
+ * to the number of vertices N and reused, each solver thread owns one.
+ *
+ * The support graph only contains the vertices with y > 0 (renumbered from 0
+ * in the order they were added) and the edges with x > 0, as an edge list.
+ */
+class SeparationWorkspace {
+
+    private:
+
+        int N;
+
+        // Vertices of the support graph
+        vector<int>    newIndicesToOld;
+        vector<int>    oldIndicesToNew;
+        vector<double> y_sol;
+
+        // Edges as they are read (i < j, new indices)
+        vector<int>    edgeFrom;
+        vector<int>    edgeTo;
+        vector<double> edgeValue;
+
+        // Components: vertices of component c are componentVertices[componentStart[c]..componentStart[c+1])
+        int numComponents;
+        vector<int>    componentStart;
+        vector<int>    componentVertices;
+        vector<int>    componentOf;
+        UnionFind      sets;
+
+        // Bitset adjacency, used for the components while the support fits in 256 vertices
+        vector<unsigned long long> adjacencyBits;
+
+        // Network of the fractional separation
+        MaxFlow        flow;
+
+        // Candidate cuts before they are checked
+        CutArena       arena;
+
+        // One flag per original vertex, left cleared by whoever sets it
+        vector<char>   marks;
+
+        // Bitset of the y and x variables at one, y first and then x row by row
+        vector<unsigned long long> support;
+        
+    public:
+
+        SeparationWorkspace();
+        ~SeparationWorkspace();
+
+        void initialise(int N);
+        
+        // O(touched): only the entries of the previous call are cleared
+        void reset();
+
+        int addVertex(int oldIndex, double y);
+        void addEdge(int i, int j, double x);
+        
+        // Returns the number of connected components of the support graph. Supports
+        // of up to 256 vertices use the bitset BFS, larger ones union-find over the
+        // edge list
+        int findComponents();
+
+        int    getNumVertices()          const { return (int)newIndicesToOld.size(); }
+        int    getNumEdges()             const { return (int)edgeFrom.size();        }
+        int    getOldIndex(int i)        const { return newIndicesToOld[i];          }
+        int    getNewIndex(int old)      const { return oldIndicesToNew[old];        }
+        double getY(int i)               const { return y_sol[i];                    }
+
+        int    getEdgeFrom(int e)        const { return edgeFrom[e];                 }
+        int    getEdgeTo(int e)          const { return edgeTo[e];                   }
+        double getEdgeValue(int e)       const { return edgeValue[e];                }
+        
+        int    getNumComponents()        const { return numComponents;                                   }
+        int    getComponentSize(int c)   const { return componentStart[c+1] - componentStart[c];         }
+        int    getComponentVertex(int c, int k) const { return componentVertices[componentStart[c] + k]; }
+        int    getComponentOf(int i)     const { return componentOf[i];                                  }
+        
+        MaxFlow      &getMaxFlow() { return flow;  }
+        CutArena     &getArena()   { return arena; }
+        vector<char> &getMarks()   { return marks; }
+        vector<unsigned long long> &getSupport() { return support; }
+};
+
+#endif
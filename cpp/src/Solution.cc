@@ -52,6 +52,22 @@ void Solution::addEdge(int i, int j) {
     edges[i].push_back(j);
 }
 
+vector<MSTEdge> Solution::getTreeEdges(const Data &data) const {
+    vector<MSTEdge> tree;
+    for (int i = 0; i < (int)edges.size(); i++) {
+        for (int k = 0; k < (int)edges[i].size(); k++) {
+            int j = edges[i][k];
+            if (j < i) continue;
+            MSTEdge edge;
+            edge.u      = i;
+            edge.v      = j;
+            edge.weight = data.getCorrelation(i, j);
+            tree.push_back(edge);
+        }
+    }
+    return tree;
+}
+
 bool Solution::checkFeasibility(const Data &data) {
 
     if (edges.size() == 0) return false;
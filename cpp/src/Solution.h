@@ -11,6 +11,7 @@
 
 #include "Util.h"
 #include "Data.h"
+#include "AlgoUtil.h"
 
 
 class Solution {
@@ -38,6 +39,8 @@ class Solution {
       
         void setNumAssets(int N);
         void addEdge(int i, int j);
+        // Each edge once (i < j), weighted by the distances of data
+        vector<MSTEdge> getTreeEdges(const Data &data) const;
         
         void setSolutionStatus(bool exists, bool optimal, bool infeasible, bool unbounded);
         void setValue(double v)      { value     = v;  }
@@ -16,16 +16,19 @@
 
 Solver::Solver() {
     status = 0;
+    numColsInSolve = 0;
+    progress = std::make_shared<SolveProgress>();
 }
 
 Solver::~Solver() {
 }
 
-int Solver::getColIndex(string name) {
-    if (colIndices.find(name) == colIndices.end()) {
+int Solver::getColIndex(const string &name) const {
+    map<string, int>::const_iterator it = colIndices.find(name);
+    if (it == colIndices.end()) {
         return -1;
     } else {
-        return colIndices[name];
+        return it->second;
     }
 }
 
@@ -47,7 +50,19 @@ double Solver::getColValue(string name) {
 
 
 void Solver::solve() {
+    progress->reset(isMaximisation());
+    runSolve();
+}
+
+SolveHandle Solver::solveAsync() {
+    progress->reset(isMaximisation());
+    std::shared_future<void> result = std::async(std::launch::async, &Solver::runSolve, this).share();
+    return SolveHandle(result, progress);
+}
+
+void Solver::runSolve() {
     colSolution.clear();
+    numColsInSolve = getNumCols();
     doSolve();
 }
 
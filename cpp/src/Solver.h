@@ -10,6 +10,9 @@
 #define SOLVER_H
 
 #include "Util.h"
+#include <atomic>
+#include <future>
+#include <memory>
 
 // Error checking
 class SolverError {
@@ -24,6 +27,89 @@ class SolverError {
 
 
 
+/**
+ * Live information about a solve, written by the solver callbacks and read
+ * by whoever holds a SolveHandle. Cancellation is cooperative: the callbacks 
+ * check isCancelRequested and ask the solver to stop.
+ */
+class SolveProgress {
+
+    private:
+        
+        std::atomic<double> incumbent;
+        std::atomic<double> bestBound;
+        std::atomic<long>   nodeCount;
+        std::atomic<bool>   incumbentFound;
+        std::atomic<bool>   cancelRequested;
+        bool maximisation;
+
+    public:
+
+        SolveProgress() { reset(false); }
+
+        void reset(bool isMax) {
+            maximisation = isMax;
+            incumbent = isMax ? -std::numeric_limits<double>::max() : std::numeric_limits<double>::max();
+            bestBound = isMax ?  std::numeric_limits<double>::max() : -std::numeric_limits<double>::max();
+            nodeCount = 0;
+            incumbentFound  = false;
+            cancelRequested = false;
+        }
+
+        // Keeps the best of the current and the new value, callbacks from several threads may race
+        void updateIncumbent(double value) {
+            double current = incumbent.load();
+            while ((maximisation ? value > current : value < current) && !incumbent.compare_exchange_weak(current, value));
+            incumbentFound = true;
+        }
+
+        void setBestBound(double bound) { bestBound = bound; }
+        void setNodeCount(long nodes)   { nodeCount = nodes; }
+        void requestCancel()            { cancelRequested = true; }
+
+        bool   isCancelRequested() const { return cancelRequested;  }
+        bool   hasIncumbent()      const { return incumbentFound;   }
+        double getIncumbent()      const { return incumbent;        }
+        double getBestBound()      const { return bestBound;        }
+        long   getNodeCount()      const { return nodeCount;        }
+};
+
+
+/**
+ * Handle to a solve running in another thread (see Solver::solveAsync)
+ */
+class SolveHandle {
+
+    private:
+
+        std::shared_future<void>       result;
+        std::shared_ptr<SolveProgress> progress;
+
+    public:
+
+        SolveHandle() {}
+        SolveHandle(std::shared_future<void> result, std::shared_ptr<SolveProgress> progress) : result(result), progress(progress) {}
+
+        bool isValid() const { return result.valid(); }
+
+        // Returns true if the solve finished within the given number of seconds
+        bool wait(double seconds) const {
+            return result.wait_for(std::chrono::duration<double>(seconds)) == std::future_status::ready;
+        }
+        
+        // Blocks until the solve finishes, rethrows any error raised by the solver
+        void get() const { result.get(); }
+
+        void cancel() { progress->requestCancel(); }
+
+        bool   hasIncumbent() const { return progress->hasIncumbent(); }
+        double getIncumbent() const { return progress->getIncumbent(); }
+        double getBestBound() const { return progress->getBestBound(); }
+        long   getNodeCount() const { return progress->getNodeCount(); }
+};
+
+
+
 /**
  * Solver, superclass of cplex, gurobi, etc.
  */
@@ -38,6 +124,12 @@ class Solver {
         int status;
         vector<double> colSolution;
 
+        // Number of columns when solve() was called, callbacks read it instead of querying the solver
+        int numColsInSolve;
+
+        std::shared_ptr<SolveProgress> progress;
+        void runSolve();
+
         // Map
         void addKey(string name, int index);
         
@@ -53,7 +145,8 @@ class Solver {
 
 
         // Map
-        int getColIndex(string name);
+        // Read-only, safe to call from concurrent callbacks
+        int getColIndex(const string &name) const;
         double getColValue(string name);
 
         // Set data
@@ -79,11 +172,21 @@ class Solver {
         virtual void relax(){} 
         // Implemented in the superclass, class the subclass method
         void solve();
+        // Same as solve, but returns immediately. Nothing else may be done with the 
+        // solver until the handle reports that the solve has finished.
+        SolveHandle solveAsync();
+
+        SolveProgress* getProgress() { return progress.get(); }
 
         // Get data
         virtual int getNumCols(){ return 0; }
         virtual int getNumRows(){ return 0; }
+        int getNumColsInSolve() const { return numColsInSolve; }
+        // Size of the problem after presolve (-1 if not available)
+        virtual int getPresolvedNumCols(){ return -1; }
+        virtual int getPresolvedNumRows(){ return -1; }
         virtual int getStatus(){ return 0; }
+        virtual bool isMaximisation(){ return false; }
         virtual double getObjValue(){return 0;}
         virtual double getBestBound(){return 0;}
         virtual void getColSolution() {}
@@ -93,6 +196,11 @@ class Solver {
         // Params
         virtual void setTimeLimit(double time) {}
         virtual void setNodeLimit(int lim) {}
+        virtual void setThreads(int threads) {}
+        // -1 - opportunistic, 0 - automatic, 1 - deterministic
+        virtual void setParallelMode(int mode) {}
+        // Solutions that do not improve on cutoff are discarded
+        virtual void setObjectiveCutoff(double cutoff) {}
         virtual void enablePresolve(bool enable = true) {}
         
         virtual void setLPMethod() {}
@@ -133,6 +241,7 @@ class Solver {
         virtual void addUserCutCallback(void* userData) {}
         virtual void addIncumbentCallback(void* userData) {}
         virtual void addNodeCallback(void* userData) {}
+        virtual void addInfoCallback(void* userData) {}
 
 
 };    
@@ -151,12 +260,16 @@ class SolverCut {
         // G - >=
         char sense;
 
+        // If true the solver may drop the cut once it stops being useful
+        bool purgeable;
+
 
     public:
     
         SolverCut() {
             sense = 0;
             rhs = 0;
+            purgeable = false;
         }
 
         ~SolverCut() {
@@ -179,6 +292,14 @@ class SolverCut {
             return lhs - rhs;
         }
 
+        // Positive if the cut is violated at vars, whatever its sense
+        double violation(const vector<double> & vars) {
+            double v = evaluate(vars);
+            if (sense == 'G') return -v;
+            if (sense == 'E') return fabs(v);
+            return v;
+        }
+
         void addCoef(int index, double coef) {
             indices.push_back(index);
             coefs.push_back(coef);
@@ -197,6 +318,10 @@ class SolverCut {
             rhs = v;
         }
 
+        void setPurgeable(bool p) {
+            purgeable = p;
+        }
+
         void setSense(char s) {
             if (s != 'L' && s != 'G' && s != 'E')
                 Util::throwInvalidArgument("Error in setSense: Invalid char %c (valid values are 'L', 'E' and 'G').", s);
@@ -212,8 +337,28 @@ class SolverCut {
         int       getIndex(int i) { return indices[i];                }
         double      getLastCoef() { return coefs[coefs.size()-1];     }
         int        getLastIndex() { return indices[indices.size()-1]; }
+        bool        isPurgeable() { return purgeable;                 }
+
 
+};
 
+/**
+ * Where the point given to Model::separationAlgorithm comes from
+ */
+struct SeparationContext {
+    int    thread;     // Solver thread, in [0, Model::getNumThreads())
+    int    depth;      // Depth of the node in the tree, -1 if unknown
+    long   node;       // Identifier of the node, -1 if unknown
+    double nodeBound;  // Objective value of the relaxation
+    bool   candidate;  // Integer solution about to be accepted: violated cuts must be returned
+
+    SeparationContext() {
+        thread    = 0;
+        depth     = -1;
+        node      = -1;
+        nodeBound = 0;
+        candidate = false;
+    }
 };
 
 #endif 
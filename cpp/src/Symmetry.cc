@@ -0,0 +1,42 @@
+/**
+ * Symmetry.cc
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "Symmetry.h"
+
+inline double edgeWeightOf(const vector<vector<double>> &edgeWeight, int i, int j) {
+    return i < j ? edgeWeight[i][j - i - 1] : edgeWeight[j][i - j - 1];
+}
+
+// Being twins is an equivalence relation (the transposition (a c) is (a b)(b c)(a b)), 
+// so each vertex only has to be compared with one representative of every class.
+vector<vector<int>> Symmetry::twinClasses(const vector<vector<double>> &edgeWeight, 
+                                          const vector<double>         &vertexWeight) {
+
+    int N = (int)vertexWeight.size();
+    vector<vector<int>> classes;
+
+    for (int a = 0; a < N; a++) {
+        int found = -1;
+        for (int c = 0; c < (int)classes.size() && found == -1; c++) {
+            int b = classes[c][0];
+            if (fabs(vertexWeight[a] - vertexWeight[b]) > TOLERANCE) continue;
+            
+            bool twins = true;
+            for (int k = 0; k < N && twins; k++) {
+                if (k == a || k == b) continue;
+                if (fabs(edgeWeightOf(edgeWeight, a, k) - edgeWeightOf(edgeWeight, b, k)) > TOLERANCE) twins = false;
+            }
+            if (twins) found = c;
+        }
+
+        if (found == -1) classes.push_back(vector<int>(1, a));
+        else             classes[found].push_back(a);
+    }
+
+    return classes;
+}
@@ -0,0 +1,35 @@
+/**
+ * Symmetry.h
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include "Util.h"
+
+////////////////////////////////////////
+
+class Symmetry {
+
+    private:
+
+
+    public:
+
+        // Partitions the vertices of a complete graph into classes of twins. Vertices a and b are 
+        // twins if swapping them leaves every weight unchanged, that is, vertexWeight[a] == vertexWeight[b] 
+        // and w(a,k) == w(b,k) for every other k. Any permutation inside a class is then a symmetry of 
+        // a model whose data are the given weights.
+        //
+        // edgeWeight is a diagonal matrix in the same format as the correlation matrix
+        // (edgeWeight[i][j - i - 1] is the weight of edge ij, i < j).
+        static vector<vector<int>> twinClasses(const vector<vector<double>> &edgeWeight, 
+                                               const vector<double>         &vertexWeight);
+
+};    
+
+#endif 
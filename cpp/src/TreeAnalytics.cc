@@ -0,0 +1,231 @@
+/**
+ * TreeAnalytics.cc
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#include "TreeAnalytics.h"
+
+
+void CSRTree::build(const vector<MSTEdge> &edges, bool weighted) {
+    vertex.clear();
+    for (unsigned e = 0; e < edges.size(); e++) {
+        vertex.push_back(edges[e].u);
+        vertex.push_back(edges[e].v);
+    }
+    std::sort(vertex.begin(), vertex.end());
+    vertex.erase(std::unique(vertex.begin(), vertex.end()), vertex.end());
+    n = vertex.size();
+    if (!edges.empty() && (int)edges.size() != n - 1) 
+        Util::throwInvalidArgument("Error in CSRTree: %d edges on %d vertices is not a tree.", (int)edges.size(), n);
+
+    auto local = [&](int v) { return (int)(std::lower_bound(vertex.begin(), vertex.end(), v) - vertex.begin()); };
+    
+    offsets.assign(n + 1, 0);
+    vector<int> ends(2 * edges.size());
+    for (unsigned e = 0; e < edges.size(); e++) {
+        ends[2*e]   = local(edges[e].u);
+        ends[2*e+1] = local(edges[e].v);
+        offsets[ends[2*e]   + 1]++;
+        offsets[ends[2*e+1] + 1]++;
+    }
+    for (int v = 0; v < n; v++) offsets[v+1] += offsets[v];
+    
+    neighbour.resize(2 * edges.size());
+    length   .resize(2 * edges.size());
+    vector<int> cursor(offsets.begin(), offsets.end() - 1);
+    for (unsigned e = 0; e < edges.size(); e++) {
+        double l = weighted ? edges[e].weight : 1;
+        int a = ends[2*e];
+        int b = ends[2*e+1];
+        neighbour[cursor[a]] = b;
+        length   [cursor[a]++] = l;
+        neighbour[cursor[b]] = a;
+        length   [cursor[b]++] = l;
+    }
+
+    // Iterative preorder from 0
+    order       .resize(n);
+    first       .resize(n);
+    parent      .assign(n, -1);
+    size        .assign(n, 1);
+    parentLength.assign(n, 0);
+    if (n == 0) return;
+    
+    // A vertex reached twice closes a cycle, so each one is pushed at most once and order never overflows
+    vector<int>  stack(1, 0);
+    vector<char> reached(n, 0);
+    reached[0] = 1;
+    int visited = 0;
+    while (!stack.empty()) {
+        int v = stack.back();
+        stack.pop_back();
+        first[v] = visited;
+        order[visited++] = v;
+        for (int k = offsets[v]; k < offsets[v+1]; k++) {
+            int w = neighbour[k];
+            if (w == parent[v]) continue;
+            if (reached[w]) Util::throwInvalidArgument("Error in CSRTree: edges do not form a tree (vertex %d closes a cycle).", vertex[w]);
+            reached[w]      = 1;
+            parent[w]       = v;
+            parentLength[w] = length[k];
+            stack.push_back(w);
+        }
+    }
+    if (visited != n) Util::throwInvalidArgument("Error in CSRTree: edges do not form a tree.");
+    for (int k = n - 1; k > 0; k--) size[parent[order[k]]] += size[order[k]];
+}
+
+
+void TreeAnalytics::distanceSums(const CSRTree &tree, vector<double> &sums) {
+    int n = tree.getNumVertices();
+    const vector<int>    &order  = tree.getOrder();
+    const vector<int>    &parent = tree.getParent();
+    const vector<int>    &size   = tree.getSubtreeSize();
+    const vector<double> &length = tree.getParentLength();
+    
+    sums.assign(n, 0);
+    if (n == 0) return;
+    
+    // Sum at the root: every edge is used once per vertex below it
+    double rootSum = 0;
+    for (int k = 1; k < n; k++) rootSum += length[order[k]] * size[order[k]];
+    sums[order[0]] = rootSum;
+    for (int k = 1; k < n; k++) {
+        int c = order[k];
+        sums[c] = sums[parent[c]] + length[c] * (n - 2 * size[c]);
+    }
+}
+
+void TreeAnalytics::betweenness(const CSRTree &tree, vector<double> &centrality) {
+    int n = tree.getNumVertices();
+    const vector<int> &parent = tree.getParent();
+    const vector<int> &size   = tree.getSubtreeSize();
+    
+    centrality.assign(n, 0);
+    for (int v = 0; v < n; v++) {
+        double branches = 0;
+        for (int k = 0; k < tree.getDegree(v); k++) {
+            int w = tree.getNeighbours(v)[k];
+            double s = w == parent[v] ? n - size[v] : size[w];
+            branches += s * s;
+        }
+        centrality[v] = ((double)(n - 1) * (n - 1) - branches) / 2;
+    }
+}
+
+void TreeAnalytics::closeness(const CSRTree &tree, vector<double> &centrality) {
+    distanceSums(tree, centrality);
+    int n = tree.getNumVertices();
+    for (int v = 0; v < n; v++) centrality[v] = centrality[v] > 0 ? (n - 1) / centrality[v] : 0;
+}
+
+double TreeAnalytics::diameter(const CSRTree &tree) {
+    int n = tree.getNumVertices();
+    if (n <= 1) return 0;
+    
+    vector<double> distance(n);
+    vector<int>    stack;
+    auto farthest = [&](int source) {
+        std::fill(distance.begin(), distance.end(), -1.0);
+        distance[source] = 0;
+        stack.assign(1, source);
+        int best = source;
+        while (!stack.empty()) {
+            int v = stack.back();
+            stack.pop_back();
+            if (distance[v] > distance[best]) best = v;
+            for (int k = 0; k < tree.getDegree(v); k++) {
+                int w = tree.getNeighbours(v)[k];
+                if (distance[w] >= 0) continue;
+                distance[w] = distance[v] + tree.getLengths(v)[k];
+                stack.push_back(w);
+            }
+        }
+        return best;
+    };
+    int end = farthest(farthest(0));
+    return distance[end];
+}
+
+void TreeAnalytics::allPairsDistances(const CSRTree &tree, vector<double> &distances) {
+    int n = tree.getNumVertices();
+    const vector<int>    &order  = tree.getOrder();
+    const vector<int>    &first  = tree.getFirst();
+    const vector<int>    &parent = tree.getParent();
+    const vector<int>    &size   = tree.getSubtreeSize();
+    const vector<double> &length = tree.getParentLength();
+
+    // Row k is the preorder vertex order[k], column j is the preorder vertex order[j]
+    vector<double> byOrder((long)n * n);
+    if (n == 0) {
+        distances.clear();
+        return;
+    }
+    double *root = &byOrder[0];
+    for (int k = 0; k < n; k++) root[k] = 0;
+    for (int k = 1; k < n; k++) root[k] = root[first[parent[order[k]]]] + length[order[k]];
+    
+    for (int k = 1; k < n; k++) {
+        int c = order[k];
+        const double *up  = &byOrder[(long)first[parent[c]] * n];
+        double       *row = &byOrder[(long)k * n];
+        double l = length[c];
+        for (int j = 0; j < n; j++) row[j] = up[j] + l;
+        for (int j = k; j < k + size[c]; j++) row[j] -= 2 * l;
+    }
+
+    distances.resize((long)n * n);
+    for (int k = 0; k < n; k++) {
+        double *row = &distances[(long)order[k] * n];
+        const double *source = &byOrder[(long)k * n];
+        for (int j = 0; j < n; j++) row[order[j]] = source[j];
+    }
+}
+
+
+TreeMetrics TreeAnalytics::analyse(const vector<MSTEdge> &edges, bool weighted) {
+    CSRTree tree;
+    tree.build(edges, weighted);
+    
+    TreeMetrics metrics;
+    vector<int> degree;
+    int n = tree.getNumVertices();
+    metrics.indices  = AlgoUtil::treeIndices(n > 0 ? tree.getVertex(n - 1) + 1 : 0, edges, degree);
+    metrics.diameter = diameter(tree);
+    metrics.vertex.resize(n);
+    for (int v = 0; v < n; v++) metrics.vertex[v] = tree.getVertex(v);
+    betweenness(tree, metrics.betweenness);
+    closeness  (tree, metrics.closeness);
+    return metrics;
+}
+
+vector<TreeMetrics> TreeAnalytics::analyse(const vector<vector<MSTEdge> > &trees, bool weighted, int threads) {
+    vector<TreeMetrics> metrics(trees.size());
+    Util::parallelFor(trees.size(), threads, [&](int, int t) {
+        metrics[t] = analyse(trees[t], weighted);
+    });
+    return metrics;
+}
+
+// Vertices numbered from 1 as in the R package
+void TreeAnalytics::print(const TreeMetrics &metrics) {
+    int central = 0;
+    int closest = 0;
+    for (unsigned v = 1; v < metrics.vertex.size(); v++) {
+        if (metrics.betweenness[v] > metrics.betweenness[central]) central = v;
+        if (metrics.closeness[v]   > metrics.closeness[closest])   closest = v;
+    }
+    
+    printf("Tree vertices:            %8d\n", (int)metrics.vertex.size());
+    printf("Assortativity:            %8.4f\n", metrics.indices.assortativity);
+    printf("Randic index:             %8.1f\n", metrics.indices.randic);
+    printf("Squared / absolute diff:  %8.1f / %.1f\n", metrics.indices.squaredDiff, metrics.indices.absoluteDiff);
+    printf("Diameter:                 %8.4f\n", metrics.diameter);
+    if (!metrics.vertex.empty()) {
+        printf("Most between vertex:      %8d (%.0f pairs)\n", metrics.vertex[central] + 1, metrics.betweenness[central]);
+        printf("Most central vertex:      %8d (closeness %.4f)\n", metrics.vertex[closest] + 1, metrics.closeness[closest]);
+    }
+}
@@ -0,0 +1,92 @@
+/**
+ * TreeAnalytics.h
+ *
+ * Copyright(c) 2016
+ * Cristiano Arbex Valle
+ * All rights reserved.
+ */
+
+#ifndef TREEANALYTICS_H
+#define TREEANALYTICS_H
+
+#include "Util.h"
+#include "AlgoUtil.h"
+
+/**
+ * Tree in CSR form over the vertices its edges touch, renumbered 0..n-1 in
+ * increasing order of their original number (so a tree of the solver, on a 
+ * subset of the assets, is as compact as an MST). Rooted at local vertex 0: 
+ * order is a preorder, and the subtree of v is order[first[v]..first[v] + size[v]).
+ */
+class CSRTree {
+
+    private:
+
+        int n;
+        vector<int>    vertex;    // original number of each local vertex
+        vector<int>    offsets;
+        vector<int>    neighbour;
+        vector<double> length;    // of the edge to neighbour, 1 if not weighted
+
+        vector<int>    order;
+        vector<int>    first;
+        vector<int>    parent;
+        vector<int>    size;
+        vector<double> parentLength;
+
+    public:
+
+        CSRTree() : n(0) {}
+
+        // Edges must form a tree. Lengths are the edge weights if weighted, otherwise 1.
+        void build(const vector<MSTEdge> &edges, bool weighted);
+
+        int getNumVertices()            const { return n; }
+        int getVertex(int v)            const { return vertex[v]; }
+        int getDegree(int v)            const { return offsets[v+1] - offsets[v]; }
+        const int*    getNeighbours(int v) const { return &neighbour[offsets[v]]; }
+        const double* getLengths(int v)    const { return &length[offsets[v]]; }
+        
+        const vector<int>    &getOrder()        const { return order;        }
+        const vector<int>    &getFirst()        const { return first;        }
+        const vector<int>    &getParent()       const { return parent;       }
+        const vector<int>    &getSubtreeSize()  const { return size;         }
+        const vector<double> &getParentLength() const { return parentLength; }
+};
+
+
+// Metrics of one tree, per local vertex of its CSRTree
+struct TreeMetrics {
+    TreeIndices    indices;
+    double         diameter;
+    vector<int>    vertex;       // original number of each local vertex
+    vector<double> betweenness;  // pairs of other vertices whose path goes through v
+    vector<double> closeness;    // (n - 1) / sum of the distances from v
+};
+
+/**
+ * Metrics of the graph.r package (degree indices) and distance based ones, 
+ * each O(n) except the O(n^2) all-pairs distances.
+ */
+class TreeAnalytics {
+
+    public:
+
+        // Sum of the distances from every vertex, by rerooting: S(c) = S(p) + l(p, c) (n - 2 size(c))
+        static void distanceSums(const CSRTree &tree, vector<double> &sums);
+        // Pairs (s, t), s != t != v, separated by v: ((n-1)^2 - sum of the squared sizes of the branches at v) / 2
+        static void betweenness(const CSRTree &tree, vector<double> &centrality);
+        static void closeness(const CSRTree &tree, vector<double> &centrality);
+        // Longest path, by two searches
+        static double diameter(const CSRTree &tree);
+        // n x n row-major, local numbering. Rows are filled in preorder, each from the row of 
+        // its parent: +l(p, c) everywhere, -2 l(p, c) on the contiguous range of the subtree of c
+        static void allPairsDistances(const CSRTree &tree, vector<double> &distances);
+
+        static TreeMetrics analyse(const vector<MSTEdge> &edges, bool weighted);
+        static void print(const TreeMetrics &metrics);
+        // Many trees on threads (0 for every core)
+        static vector<TreeMetrics> analyse(const vector<vector<MSTEdge> > &trees, bool weighted, int threads = 1);
+};
+
+#endif
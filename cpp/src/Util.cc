@@ -12,6 +12,9 @@
 #include <string.h>
 #include <sstream>
 #include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -49,6 +52,7 @@ long gettimeofday(struct timezone * tzp) {
 #include <sys/times.h>
 #include <sys/resource.h>
 #include <sys/unistd.h>
+#include <time.h>
 #endif
 
 #include <sys/stat.h>
@@ -106,6 +110,41 @@ float Util::getTime() {
 #endif
 }
 
+double Util::getThreadTime() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) return getWallTime();
+    return (((uint64_t)user.dwHighDateTime << 32) | user.dwLowDateTime) * 1e-7;
+#else
+    struct timespec now;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0) return getWallTime();
+    return now.tv_sec + now.tv_nsec * 1e-9;
+#endif
+}
+
+double Util::getWallTime() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int Util::getNumThreads(int threads) {
+    if (threads > 0) return threads;
+    return std::max(1, (int)std::thread::hardware_concurrency());
+}
+
+void Util::parallelFor(int numItems, int threads, const std::function<void(int, int)> &body) {
+    threads = std::min(getNumThreads(threads), std::max(1, numItems));
+    std::atomic<int> nextItem(0);
+    
+    auto worker = [&](int thread) {
+        for (int item = nextItem++; item < numItems; item = nextItem++) body(thread, item);
+    };
+    
+    vector<std::thread> workers;
+    for (int t = 1; t < threads; t++) workers.push_back(std::thread(worker, t));
+    worker(0);
+    for (unsigned t = 0; t < workers.size(); t++) workers[t].join();
+}
+
 
 // Get current date/time, format is YYYY-MM-DD.HH:mm:ss
 const string Util::getCurrentDateTime() {
@@ -71,6 +71,7 @@ using std::to_string;
 #include <map>
 #include <stdexcept>
 #include <limits>
+#include <functional>
 #include <boost/lexical_cast.hpp>
 
 using std::string;
@@ -95,6 +96,18 @@ class Util {
          * Retorna o tempo de sistema.
          */
         static float getTime();
+        // Elapsed (not CPU) time in seconds from an arbitrary origin, for code that runs on several threads
+        static double getWallTime();
+        // CPU time of the calling thread only, for intervals measured inside solver callbacks
+        static double getThreadTime();
+
+        /**
+         * Runs body(thread, item) for every item in [0, numItems) on threads threads (0 for 
+         * every core). Items are handed out one at a time, so uneven items are balanced; 
+         * thread is in [0, threads) and can index per-thread buffers.
+         */
+        static void parallelFor(int numItems, int threads, const std::function<void(int, int)> &body);
+        static int  getNumThreads(int threads);
         static const string getCurrentDateTime();
 
         /**
@@ -8,6 +8,7 @@
 
 #include "Options.h"
 #include "AssortMST.h"
+#include "NetworkAnalysis.h"
 
 void finalise() {
     Options::finalise();
@@ -23,6 +24,9 @@ int main(int argc, char *argv[]) {
         if (Options::getInstance()->getStringOption("model").compare("assort_mst") == 0) {
             AssortMST assortMST;
             assortMST.execute();
+        } else {
+            NetworkAnalysis analysis;
+            analysis.execute();
         }
 
 